@@ -0,0 +1,470 @@
+//
+// benchmark.cpp
+//
+// A separate executable that times every engine on square boards from 64x64 up to
+// 16384x16384, seeded with random soups and with known patterns, and prints the results as
+// JSON so they can be compared between releases.  Progress goes to std::cerr so std::cout
+// can be redirected straight into a file.
+//
+// The CPU bloom is timed too at the default screen size, and so is each BloomQuality if this
+// machine has shaders.
+//
+#include "bloom-shader.hpp"
+#include "config.hpp"
+#include "cpu-bloom.hpp"
+#include "grid.hpp"
+#include "patterns.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#ifndef GAME_OF_LIFE_VERSION
+#define GAME_OF_LIFE_VERSION "unknown"
+#endif
+
+namespace gameoflife
+{
+
+    namespace
+    {
+        constexpr std::size_t max_generations{ 1 << 20 };
+        constexpr std::size_t max_bloom_frames{ 1 << 12 };
+        constexpr unsigned random_seed{ 12345 };
+
+        // HashLife only pays off when the board has structure to remember, and seeding it with
+        // bigger soups than this just measures how it runs out of memory
+        constexpr std::size_t max_hashlife_soup_size{ 1024 };
+
+        struct Options
+        {
+            std::size_t max_size{ 16384 };
+            double min_seconds{ 0.25 }; // of each timed run, so the clock's resolution is moot
+            std::size_t thread_count{ 0 };
+            std::vector<EngineType> engines;
+            bool is_bloom_timed{ true };
+        };
+
+        struct Start
+        {
+            std::string name;
+            float density{ 0.0f };                  // of a random soup, if there is no pattern
+            const Pattern * pattern_ptr{ nullptr }; // centered on the board
+        };
+
+        struct Result
+        {
+            std::string engine;
+            std::string start;
+            std::size_t size{ 0 };
+            std::size_t generations{ 0 };
+            double seconds{ 0.0 };
+            std::size_t bytes{ 0 };
+            std::size_t population{ 0 };
+        };
+
+        struct BloomResult
+        {
+            std::string quality;
+            sf::Vector2u size;
+            std::size_t frames{ 0 };
+            double seconds{ 0.0 };
+        };
+
+        Options parseOptions(const int t_argc, const char * const t_argv[])
+        {
+            Options options;
+            options.engines = { EngineType::Reference, EngineType::BitPacked, EngineType::Tiled,
+                                EngineType::Table,     EngineType::Sparse,    EngineType::HashLife };
+
+            bool isEngineListed{ false };
+            for (int index{ 1 }; index < t_argc; ++index)
+            {
+                const std::string_view argument{ t_argv[index] };
+                const std::size_t equals{ argument.find('=') };
+                const std::string_view name{ argument.substr(0, equals) };
+                const std::string value{ (equals == std::string_view::npos)
+                                             ? std::string{}
+                                             : std::string{ argument.substr(equals + 1) } };
+
+                if (name == "--max-size")
+                {
+                    options.max_size = std::stoul(value);
+                }
+                else if (name == "--seconds")
+                {
+                    options.min_seconds = std::stod(value);
+                }
+                else if (name == "--threads")
+                {
+                    options.thread_count = std::stoul(value);
+                }
+                else if (name == "--engine")
+                {
+                    if (!isEngineListed)
+                    {
+                        options.engines.clear();
+                        isEngineListed = true;
+                    }
+
+                    options.engines.push_back(parseEngineType(value));
+                }
+                else if (name == "--no-bloom")
+                {
+                    options.is_bloom_timed = false;
+                }
+                else
+                {
+                    throw std::runtime_error(
+                        "Unknown argument \"" + std::string{ argument } +
+                        "\".  Try --max-size=N, --seconds=S, --threads=N, --no-bloom and "
+                        "--engine=NAME, which can be repeated.");
+                }
+            }
+
+            return options;
+        }
+
+        std::vector<Start> makeStarts()
+        {
+            std::vector<Start> starts;
+
+            for (const float density : { 0.1f, 0.25f, 0.5f })
+            {
+                starts.push_back(
+                    { ("random-" + std::to_string(static_cast<int>(density * 100.0f)) + "%"),
+                      density,
+                      nullptr });
+            }
+
+            for (const std::string_view name : { "r-pentomino", "gosper-glider-gun" })
+            {
+                starts.push_back({ std::string{ name }, 0.0f, findPresetPattern(name) });
+            }
+
+            return starts;
+        }
+
+        bool isWorthRunning(
+            const EngineType t_engine, const Start & t_start, const std::size_t t_size)
+        {
+            return (
+                (t_engine != EngineType::HashLife) || (t_start.pattern_ptr != nullptr) ||
+                (t_size <= max_hashlife_soup_size));
+        }
+
+        double secondsToStep(Grid & t_grid, const std::size_t t_count)
+        {
+            const auto startTime{ std::chrono::steady_clock::now() };
+            t_grid.processSteps(t_count);
+            const std::chrono::duration<double> elapsed{ std::chrono::steady_clock::now() -
+                                                         startTime };
+
+            return elapsed.count();
+        }
+
+        // t_soup is only used if t_start has no pattern
+        Result run(
+            const Options & t_options,
+            const EngineType t_engine,
+            const Start & t_start,
+            const CellBuffer & t_soup,
+            const std::size_t t_size)
+        {
+            Config config;
+            config.cell_counts  = { static_cast<unsigned>(t_size), static_cast<unsigned>(t_size) };
+            config.engine       = t_engine;
+            config.thread_count = t_options.thread_count;
+
+            Grid grid;
+            grid.reset(config);
+
+            if (t_start.pattern_ptr == nullptr)
+            {
+                grid.loadCells(t_soup);
+            }
+            else
+            {
+                placePattern(grid, *t_start.pattern_ptr, sf::Vector2i{ config.cell_counts / 2u });
+            }
+
+            // the first step includes loading the engine, so it isn't timed
+            grid.processSteps(1);
+
+            // keep doubling until one run takes long enough to trust
+            Result result{ std::string{ toString(t_engine) }, t_start.name, t_size, 1, 0.0, 0, 0 };
+            result.seconds = secondsToStep(grid, result.generations);
+            while ((result.seconds < t_options.min_seconds) &&
+                   (result.generations < max_generations))
+            {
+                result.generations *= 2;
+                result.seconds = secondsToStep(grid, result.generations);
+            }
+
+            result.bytes      = grid.engineByteCount();
+            result.population = grid.countAliveCells();
+            return result;
+        }
+
+        double secondsToBloom(
+            util::BloomEffect & t_bloom,
+            const sf::RenderTexture & t_input,
+            sf::RenderTexture & t_output,
+            const std::size_t t_count)
+        {
+            const auto startTime{ std::chrono::steady_clock::now() };
+            for (std::size_t count{ 0 }; count < t_count; ++count)
+            {
+                t_bloom.apply(t_input, t_output);
+                t_output.display();
+            }
+
+            // the GPU works behind the CPU, so wait until it has really finished all of them
+            static_cast<void>(t_output.getTexture().copyToImage());
+
+            const std::chrono::duration<double> elapsed{ std::chrono::steady_clock::now() -
+                                                         startTime };
+
+            return elapsed.count();
+        }
+
+        double secondsToCpuBloom(
+            CpuBloom & t_bloom,
+            const std::vector<std::uint8_t> & t_input,
+            std::vector<std::uint8_t> & t_output,
+            const sf::Vector2u & t_size,
+            const std::size_t t_count)
+        {
+            const auto startTime{ std::chrono::steady_clock::now() };
+            for (std::size_t count{ 0 }; count < t_count; ++count)
+            {
+                t_bloom.apply(t_input.data(), t_output.data(), t_size);
+            }
+
+            const std::chrono::duration<double> elapsed{ std::chrono::steady_clock::now() -
+                                                         startTime };
+
+            return elapsed.count();
+        }
+
+        // what machines without shaders get, minus reading the frame back from the video card
+        std::vector<BloomResult> runCpuBloom(const Options & t_options, const Config & t_config)
+        {
+            const sf::Vector2u size{ t_config.video_mode.size };
+
+            const sf::Color & color{ t_config.grid_color_on };
+            std::vector<std::uint8_t> input;
+            input.reserve(static_cast<std::size_t>(size.x) * size.y * 4);
+            for (std::size_t index{ 0 }; index < (static_cast<std::size_t>(size.x) * size.y);
+                 ++index)
+            {
+                input.insert(input.end(), { color.r, color.g, color.b, color.a });
+            }
+
+            std::vector<std::uint8_t> output(input.size());
+
+            CpuBloom bloom{ t_options.thread_count };
+            bloom.blurMultiPassCount(3);
+
+            // the first frame includes sizing the buffers, so it isn't timed
+            secondsToCpuBloom(bloom, input, output, size, 1);
+
+            std::vector<BloomResult> results;
+            for (const util::BloomQuality quality :
+                 { util::BloomQuality::Low, util::BloomQuality::Medium, util::BloomQuality::High })
+            {
+                const std::string name{ "cpu-" + std::string{ util::toString(quality) } };
+                std::cerr << "bloom " << name << ' ' << size.x << 'x' << size.y << "..."
+                          << std::endl;
+
+                bloom.quality(quality);
+
+                BloomResult result{ name, size, 1, 0.0 };
+                result.seconds = secondsToCpuBloom(bloom, input, output, size, result.frames);
+                while ((result.seconds < t_options.min_seconds) &&
+                       (result.frames < max_bloom_frames))
+                {
+                    result.frames *= 2;
+                    result.seconds = secondsToCpuBloom(bloom, input, output, size, result.frames);
+                }
+
+                results.push_back(result);
+            }
+
+            return results;
+        }
+
+        std::vector<BloomResult> runBloom(const Options & t_options)
+        {
+            // every pass costs the same whatever is drawn, only the size matters
+            const Config config;
+            const sf::Vector2u size{ config.video_mode.size };
+
+            std::vector<BloomResult> results{ runCpuBloom(t_options, config) };
+
+            if (!util::BloomEffect::isSupported())
+            {
+                std::cerr << "No shaders on this machine, so only the CPU bloom is timed."
+                          << std::endl;
+
+                return results;
+            }
+
+            sf::RenderTexture input;
+            sf::RenderTexture output;
+            if (!input.resize(size) || !output.resize(size))
+            {
+                throw std::runtime_error("Could not make the render textures to time bloom with.");
+            }
+
+            input.clear(config.grid_color_on);
+            input.display();
+
+            for (const util::BloomQuality quality :
+                 { util::BloomQuality::Off,
+                   util::BloomQuality::Low,
+                   util::BloomQuality::Medium,
+                   util::BloomQuality::High })
+            {
+                std::cerr << "bloom " << util::toString(quality) << ' ' << size.x << 'x' << size.y
+                          << "..." << std::endl;
+
+                // the same multipass count as the game uses
+                util::BloomEffect bloom;
+                bloom.quality(quality);
+                bloom.blurMultiPassCount(3);
+
+                // the first frame includes making the textures, so it isn't timed
+                secondsToBloom(bloom, input, output, 1);
+
+                BloomResult result{ std::string{ util::toString(quality) }, size, 1, 0.0 };
+                result.seconds = secondsToBloom(bloom, input, output, result.frames);
+                while ((result.seconds < t_options.min_seconds) &&
+                       (result.frames < max_bloom_frames))
+                {
+                    result.frames *= 2;
+                    result.seconds = secondsToBloom(bloom, input, output, result.frames);
+                }
+
+                results.push_back(result);
+            }
+
+            return results;
+        }
+
+        void printJson(
+            const Options & t_options,
+            const std::vector<Result> & t_results,
+            const std::vector<BloomResult> & t_bloomResults)
+        {
+            const std::size_t threadCount{ (t_options.thread_count > 0)
+                                               ? t_options.thread_count
+                                               : std::thread::hardware_concurrency() };
+
+            std::cout << "{\n"
+                      << "  \"version\": \"" << GAME_OF_LIFE_VERSION << "\",\n"
+                      << "  \"threads\": " << threadCount << ",\n"
+                      << "  \"simd\": \"" << toString(detectSimdLevel()) << "\",\n"
+                      << "  \"results\": [";
+
+            for (std::size_t index{ 0 }; index < t_results.size(); ++index)
+            {
+                const Result & result{ t_results[index] };
+
+                const double cellCount{ static_cast<double>(result.size) *
+                                        static_cast<double>(result.size) };
+
+                const double generationsPerSec{ static_cast<double>(result.generations) /
+                                                result.seconds };
+
+                std::cout << ((index == 0) ? "\n" : ",\n") << "    { \"engine\": \""
+                          << result.engine << "\", \"start\": \"" << result.start
+                          << "\", \"width\": " << result.size << ", \"height\": " << result.size
+                          << ", \"generations\": " << result.generations
+                          << ", \"seconds\": " << result.seconds
+                          << ", \"generations_per_sec\": " << generationsPerSec
+                          << ", \"cells_per_sec\": " << (generationsPerSec * cellCount)
+                          << ", \"bytes_per_cell\": "
+                          << (static_cast<double>(result.bytes) / cellCount)
+                          << ", \"final_population\": " << result.population << " }";
+            }
+
+            std::cout << "\n  ],\n  \"bloom\": [";
+
+            for (std::size_t index{ 0 }; index < t_bloomResults.size(); ++index)
+            {
+                const BloomResult & result{ t_bloomResults[index] };
+
+                std::cout << ((index == 0) ? "\n" : ",\n") << "    { \"quality\": \""
+                          << result.quality << "\", \"width\": " << result.size.x
+                          << ", \"height\": " << result.size.y << ", \"frames\": " << result.frames
+                          << ", \"seconds\": " << result.seconds << ", \"ms_per_frame\": "
+                          << ((result.seconds * 1000.0) / static_cast<double>(result.frames))
+                          << " }";
+            }
+
+            std::cout << "\n  ]\n}\n";
+        }
+    } // namespace
+
+} // namespace gameoflife
+
+int main(int argc, char * argv[])
+{
+    try
+    {
+        using namespace gameoflife;
+
+        const Options options{ parseOptions(argc, argv) };
+        const std::vector<Start> starts{ makeStarts() };
+
+        std::vector<Result> results;
+        for (std::size_t size{ 64 }; size <= options.max_size; size *= 4)
+        {
+            for (const Start & start : starts)
+            {
+                // made once for every engine, since a big soup takes longer to make than to time
+                CellBuffer soup;
+                if (start.pattern_ptr == nullptr)
+                {
+                    soup.resize(size, size);
+                    fillRandomCells(soup, start.density, random_seed);
+                }
+
+                for (const EngineType engine : options.engines)
+                {
+                    if (!isWorthRunning(engine, start, size))
+                    {
+                        continue;
+                    }
+
+                    std::cerr << toString(engine) << ' ' << start.name << ' ' << size << 'x'
+                              << size << "..." << std::endl;
+
+                    results.push_back(run(options, engine, start, soup, size));
+                }
+            }
+        }
+
+        std::vector<BloomResult> bloomResults;
+        if (options.is_bloom_timed)
+        {
+            bloomResults = runBloom(options);
+        }
+
+        printJson(options, results, bloomResults);
+    }
+    catch (const std::exception & ex)
+    {
+        std::cerr << "Exception Error: " << ex.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
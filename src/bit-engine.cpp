@@ -0,0 +1,361 @@
+//
+// bit-engine.cpp
+//
+#include "bit-engine.hpp"
+
+#include <algorithm>
+
+namespace gameoflife
+{
+
+    namespace
+    {
+        // a band smaller than this is done before the other threads could even wake up
+        constexpr std::size_t min_words_per_band{ 16 * 1024 };
+    } // namespace
+
+    BitEngine::BitEngine(
+        ThreadPool & t_threadPool,
+        const Rule & t_rule,
+        const bool t_isToroidal,
+        const bool t_willSkipStableTiles)
+        : m_threadPool{ t_threadPool }
+        , m_rule{ t_rule }
+        , m_isToroidal{ t_isToroidal }
+        , m_willSkipStableTiles{ t_willSkipStableTiles }
+        , m_width{ 0 }
+        , m_height{ 0 }
+        , m_wordsPerRow{ 0 }
+        , m_lastWordMask{ 0 }
+        , m_words{}
+        , m_nextWords{}
+        , m_tileRowCount{ 0 }
+        , m_changedTiles{}
+        , m_nextChangedTiles{}
+    {}
+
+    void BitEngine::resize(const std::size_t t_width, const std::size_t t_height)
+    {
+        m_width       = t_width;
+        m_height      = t_height;
+        m_wordsPerRow = ((t_width + bits_per_word - 1) / bits_per_word);
+
+        const std::size_t usedBits{ t_width % bits_per_word };
+        m_lastWordMask = ((usedBits == 0) ? ~Word_t{ 0 } : ((Word_t{ 1 } << usedBits) - 1));
+
+        // plus the two padding rows
+        const std::size_t wordCount{ m_wordsPerRow * (t_height + 2) };
+        m_words.assign(wordCount, 0);
+        m_nextWords.assign(wordCount, 0);
+
+        // every tile starts as changed so the first step does them all
+        m_tileRowCount = ((t_height + tile_rows - 1) / tile_rows);
+        m_changedTiles.assign((m_tileRowCount * m_wordsPerRow), 1);
+        m_nextChangedTiles.assign((m_tileRowCount * m_wordsPerRow), 1);
+    }
+
+    void BitEngine::load(const CellBuffer & t_cells)
+    {
+        resize(t_cells.width(), t_cells.height());
+
+        for (std::size_t y{ 0 }; y < m_height; ++y)
+        {
+            packRow(t_cells.row(y), m_width, row(m_words, (y + 1)));
+        }
+
+        // skipped tiles rely on both buffers matching
+        m_nextWords = m_words;
+    }
+
+    void BitEngine::store(CellBuffer & t_cells) const
+    {
+        for (std::size_t y{ 0 }; y < m_height; ++y)
+        {
+            unpackRow(row(m_words, (y + 1)), m_width, t_cells.row(y));
+        }
+    }
+
+    bool BitEngine::getCell(const std::size_t t_x, const std::size_t t_y) const
+    {
+        if ((t_x >= m_width) || (t_y >= m_height))
+        {
+            return false;
+        }
+
+        return (((row(m_words, (t_y + 1))[t_x / bits_per_word] >> (t_x % bits_per_word)) & 1) !=
+                0);
+    }
+
+    void BitEngine::setCell(const std::size_t t_x, const std::size_t t_y, const bool t_isAlive)
+    {
+        if ((t_x >= m_width) || (t_y >= m_height))
+        {
+            return;
+        }
+
+        const std::size_t wordIndex{ ((t_y + 1) * m_wordsPerRow) + (t_x / bits_per_word) };
+        const Word_t bit{ Word_t{ 1 } << (t_x % bits_per_word) };
+
+        // both buffers because skipped tiles rely on them matching
+        if (t_isAlive)
+        {
+            m_words[wordIndex] |= bit;
+            m_nextWords[wordIndex] |= bit;
+        }
+        else
+        {
+            m_words[wordIndex] &= ~bit;
+            m_nextWords[wordIndex] &= ~bit;
+        }
+
+        m_changedTiles[((t_y / tile_rows) * m_wordsPerRow) + (t_x / bits_per_word)] = 1;
+    }
+
+    void BitEngine::processStep()
+    {
+        if (m_wordsPerRow == 0)
+        {
+            return;
+        }
+
+        if (m_isToroidal)
+        {
+            std::copy_n(row(m_words, m_height), m_wordsPerRow, row(m_words, 0));
+            std::copy_n(row(m_words, 1), m_wordsPerRow, row(m_words, (m_height + 1)));
+        }
+
+        // each band only reads m_words and only writes its own rows of m_nextWords
+        const std::size_t minRowsPerBand{ std::max(
+            std::size_t{ 1 }, (min_words_per_band / m_wordsPerRow)) };
+
+        withWordStepper(m_rule, [&](const auto & t_step) {
+            if (m_willSkipStableTiles)
+            {
+                m_threadPool.forEachBand(
+                    m_tileRowCount,
+                    std::max(std::size_t{ 1 }, (minRowsPerBand / tile_rows)),
+                    [&](const std::size_t t_beginTileY, const std::size_t t_endTileY) {
+                        processTileRows(t_beginTileY, t_endTileY, t_step);
+                    });
+            }
+            else
+            {
+                m_threadPool.forEachBand(
+                    m_height,
+                    minRowsPerBand,
+                    [&](const std::size_t t_beginY, const std::size_t t_endY) {
+                        processRows(t_beginY, t_endY, t_step);
+                    });
+            }
+        });
+
+        if (m_willSkipStableTiles)
+        {
+            m_changedTiles.swap(m_nextChangedTiles);
+        }
+
+        // the padding rows are never written by a step (and are refreshed first on a torus)
+        m_words.swap(m_nextWords);
+    }
+
+    bool BitEngine::isTileActive(const std::size_t t_tileX, const std::size_t t_tileY) const
+    {
+        const std::ptrdiff_t columnCount{ static_cast<std::ptrdiff_t>(m_wordsPerRow) };
+        const std::ptrdiff_t rowCount{ static_cast<std::ptrdiff_t>(m_tileRowCount) };
+
+        for (std::ptrdiff_t offsetY{ -1 }; offsetY <= 1; ++offsetY)
+        {
+            for (std::ptrdiff_t offsetX{ -1 }; offsetX <= 1; ++offsetX)
+            {
+                std::ptrdiff_t tileX{ static_cast<std::ptrdiff_t>(t_tileX) + offsetX };
+                std::ptrdiff_t tileY{ static_cast<std::ptrdiff_t>(t_tileY) + offsetY };
+
+                // on a torus the tiles along each edge are next to those along the opposite one
+                if (m_isToroidal)
+                {
+                    tileX = ((tileX + columnCount) % columnCount);
+                    tileY = ((tileY + rowCount) % rowCount);
+                }
+                else if (
+                    (tileX < 0) || (tileY < 0) || (tileX >= columnCount) || (tileY >= rowCount))
+                {
+                    continue;
+                }
+
+                if (m_changedTiles[static_cast<std::size_t>((tileY * columnCount) + tileX)] != 0)
+                {
+                    return true;
+                }
+            }
+        }
+
+        return false;
+    }
+
+    template <typename Stepper_t>
+    void BitEngine::processTileRows(
+        const std::size_t t_beginTileY, const std::size_t t_endTileY, const Stepper_t & t_step)
+    {
+        constexpr std::uint8_t is_active{ 1 };
+        constexpr std::uint8_t is_changed{ 2 };
+
+        // locals because the flag writes below could otherwise alias any member
+        const std::size_t wordsPerRow{ m_wordsPerRow };
+        const std::size_t lastWord{ wordsPerRow - 1 };
+        const Word_t lastWordMask{ m_lastWordMask };
+
+        for (std::size_t tileY{ t_beginTileY }; tileY < t_endTileY; ++tileY)
+        {
+            // flags for this step are kept in the next changed array until the tile row is done
+            std::uint8_t * flags{ m_nextChangedTiles.data() + (tileY * wordsPerRow) };
+            for (std::size_t w{ 0 }; w < wordsPerRow; ++w)
+            {
+                flags[w] = (isTileActive(w, tileY) ? is_active : 0);
+            }
+
+            // plus one for the top padding row
+            const std::size_t beginY{ (tileY * tile_rows) + 1 };
+            const std::size_t endY{ std::min((beginY + tile_rows), (m_height + 1)) };
+
+            for (std::size_t y{ beginY }; y < endY; ++y)
+            {
+                const Word_t * above{ row(m_words, (y - 1)) };
+                const Word_t * middle{ row(m_words, y) };
+                const Word_t * below{ row(m_words, (y + 1)) };
+                Word_t * next{ row(m_nextWords, y) };
+
+                const RowGhosts aboveGhosts{ ghostsOf(above) };
+                const RowGhosts middleGhosts{ ghostsOf(middle) };
+                const RowGhosts belowGhosts{ ghostsOf(below) };
+
+                std::size_t w{ 0 };
+                while (w < wordsPerRow)
+                {
+                    if (flags[w] == 0)
+                    {
+                        ++w;
+                        continue;
+                    }
+
+                    // same sliding window as processRows(), restarted at each run of active tiles
+                    Word_t abovePrev{ (w == 0) ? aboveGhosts.before : above[w - 1] };
+                    Word_t aboveWord{ above[w] };
+                    Word_t prev{ (w == 0) ? middleGhosts.before : middle[w - 1] };
+                    Word_t word{ middle[w] };
+                    Word_t belowPrev{ (w == 0) ? belowGhosts.before : below[w - 1] };
+                    Word_t belowWord{ below[w] };
+
+                    for (; (w < wordsPerRow) && (flags[w] != 0); ++w)
+                    {
+                        const bool isLast{ w == lastWord };
+                        const Word_t aboveNext{ isLast ? aboveGhosts.after : above[w + 1] };
+                        const Word_t nextWord{ isLast ? middleGhosts.after : middle[w + 1] };
+                        const Word_t belowNext{ isLast ? belowGhosts.after : below[w + 1] };
+
+                        const Word_t stepped{ (isLast ? lastWordMask : ~Word_t{ 0 }) &
+                                              t_step(
+                                                  abovePrev,
+                                                  (aboveWord | (isLast ? aboveGhosts.inLast : 0)),
+                                                  aboveNext,
+                                                  prev,
+                                                  (word | (isLast ? middleGhosts.inLast : 0)),
+                                                  nextWord,
+                                                  belowPrev,
+                                                  (belowWord | (isLast ? belowGhosts.inLast : 0)),
+                                                  belowNext) };
+
+                        // without a branch because which words change is close to random
+                        flags[w] |= ((stepped != word) ? is_changed : std::uint8_t{ 0 });
+
+                        next[w] = stepped;
+
+                        abovePrev = aboveWord;
+                        aboveWord = aboveNext;
+                        prev      = word;
+                        word      = nextWord;
+                        belowPrev = belowWord;
+                        belowWord = belowNext;
+                    }
+                }
+            }
+
+            for (std::size_t w{ 0 }; w < wordsPerRow; ++w)
+            {
+                flags[w] = (((flags[w] & is_changed) == 0) ? 0 : 1);
+            }
+        }
+    }
+
+    template <typename Stepper_t>
+    void BitEngine::processRows(
+        const std::size_t t_beginY, const std::size_t t_endY, const Stepper_t & t_step)
+    {
+        const std::size_t lastWord{ m_wordsPerRow - 1 };
+
+        for (std::size_t y{ t_beginY + 1 }; y <= t_endY; ++y)
+        {
+            const Word_t * above{ row(m_words, (y - 1)) };
+            const Word_t * middle{ row(m_words, y) };
+            const Word_t * below{ row(m_words, (y + 1)) };
+            Word_t * next{ row(m_nextWords, y) };
+
+            // all zero (dead) unless on a torus
+            const RowGhosts aboveGhosts{ ghostsOf(above) };
+            const RowGhosts middleGhosts{ ghostsOf(middle) };
+            const RowGhosts belowGhosts{ ghostsOf(below) };
+
+            // slide a three word window along the row so each word is only loaded once
+            Word_t abovePrev{ aboveGhosts.before };
+            Word_t aboveWord{ above[0] };
+            Word_t prev{ middleGhosts.before };
+            Word_t word{ middle[0] };
+            Word_t belowPrev{ belowGhosts.before };
+            Word_t belowWord{ below[0] };
+
+            for (std::size_t w{ 0 }; w < lastWord; ++w)
+            {
+                const Word_t aboveNext{ above[w + 1] };
+                const Word_t nextWord{ middle[w + 1] };
+                const Word_t belowNext{ below[w + 1] };
+
+                next[w] = t_step(
+                    abovePrev,
+                    aboveWord,
+                    aboveNext,
+                    prev,
+                    word,
+                    nextWord,
+                    belowPrev,
+                    belowWord,
+                    belowNext);
+
+                abovePrev = aboveWord;
+                aboveWord = aboveNext;
+                prev      = word;
+                word      = nextWord;
+                belowPrev = belowWord;
+                belowWord = belowNext;
+            }
+
+            next[lastWord] = (t_step(
+                                  abovePrev,
+                                  (aboveWord | aboveGhosts.inLast),
+                                  aboveGhosts.after,
+                                  prev,
+                                  (word | middleGhosts.inLast),
+                                  middleGhosts.after,
+                                  belowPrev,
+                                  (belowWord | belowGhosts.inLast),
+                                  belowGhosts.after) &
+                              m_lastWordMask);
+        }
+    }
+
+    std::size_t BitEngine::byteCount() const
+    {
+        return (
+            ((m_words.capacity() + m_nextWords.capacity()) * sizeof(Word_t)) +
+            m_changedTiles.capacity() + m_nextChangedTiles.capacity());
+    }
+
+} // namespace gameoflife
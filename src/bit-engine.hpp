@@ -0,0 +1,109 @@
+#ifndef BIT_ENGINE_HPP_INCLUDED
+#define BIT_ENGINE_HPP_INCLUDED
+//
+// bit-engine.hpp
+//
+#include "bit-kernel.hpp"
+#include "engine.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace gameoflife
+{
+
+    // one word wide, so a tile is 64x64 cells
+    constexpr std::size_t tile_rows{ 64 };
+
+    // Packs each row into 64-bit words (bit n of word w is cell x=(w*64)+n) and advances all
+    // 64 cells of a word at once by adding the eight neighbour words with bit-sliced adders.
+    // Rows are stored with one dead padding row above and below so the kernel never has to
+    // check the top or bottom edge, and the unused bits past the right edge are kept zero.
+    //
+    // On a torus the padding rows are refreshed with copies of the opposite rows before each
+    // step, and the cells past the left and right edges are supplied by wrapRow() per row.
+    //
+    // When skipping stable tiles, the board is also split into 64x64 tiles that remember if
+    // they changed last step.  A tile is only stepped if it or one of its eight neighbours
+    // changed, because otherwise it can't change this step either.  Both buffers always hold
+    // the same cells for a tile that did not change, so skipping it needs no copying.
+    class BitEngine : public IEngine
+    {
+      public:
+        BitEngine(
+            ThreadPool & t_threadPool,
+            const Rule & t_rule,
+            const bool t_isToroidal,
+            const bool t_willSkipStableTiles);
+        virtual ~BitEngine() override = default;
+
+        std::string_view name() const override
+        {
+            return (m_willSkipStableTiles ? "bit-packed-tiled" : "bit-packed");
+        }
+
+        void load(const CellBuffer & t_cells) override;
+        void store(CellBuffer & t_cells) const override;
+        std::size_t byteCount() const override;
+
+        void processStep() override;
+
+        std::size_t width() const { return m_width; }
+        std::size_t height() const { return m_height; }
+
+        bool getCell(const std::size_t t_x, const std::size_t t_y) const;
+        void setCell(const std::size_t t_x, const std::size_t t_y, const bool t_isAlive);
+
+      private:
+        void resize(const std::size_t t_width, const std::size_t t_height);
+
+        // [t_beginY, t_endY) of the board, so NOT including the top padding row
+        template <typename Stepper_t>
+        void processRows(
+            const std::size_t t_beginY, const std::size_t t_endY, const Stepper_t & t_step);
+
+        // [t_beginTileY, t_endTileY) of the tile rows, skipping tiles that can't change
+        template <typename Stepper_t>
+        void processTileRows(
+            const std::size_t t_beginTileY,
+            const std::size_t t_endTileY,
+            const Stepper_t & t_step);
+
+        bool isTileActive(const std::size_t t_tileX, const std::size_t t_tileY) const;
+
+        RowGhosts ghostsOf(const Word_t * const t_row) const
+        {
+            return (m_isToroidal ? wrapRow(t_row, m_width) : RowGhosts{});
+        }
+
+        // includes the top padding row, so t_y=0 is the padding row
+        Word_t * row(std::vector<Word_t> & t_words, const std::size_t t_y)
+        {
+            return (t_words.data() + (t_y * m_wordsPerRow));
+        }
+
+        const Word_t * row(const std::vector<Word_t> & t_words, const std::size_t t_y) const
+        {
+            return (t_words.data() + (t_y * m_wordsPerRow));
+        }
+
+      private:
+        ThreadPool & m_threadPool;
+        Rule m_rule;
+        bool m_isToroidal;
+        bool m_willSkipStableTiles;
+        std::size_t m_width;
+        std::size_t m_height;
+        std::size_t m_wordsPerRow;
+        Word_t m_lastWordMask;
+        std::vector<Word_t> m_words;
+        std::vector<Word_t> m_nextWords;
+        std::size_t m_tileRowCount;
+        std::vector<std::uint8_t> m_changedTiles; // last step, by tile row then word
+        std::vector<std::uint8_t> m_nextChangedTiles;
+    };
+
+} // namespace gameoflife
+
+#endif // BIT_ENGINE_HPP_INCLUDED
@@ -0,0 +1,88 @@
+//
+// bit-kernel.cpp
+//
+#include "bit-kernel.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+
+namespace gameoflife
+{
+
+    namespace
+    {
+        // each of the 256 byte values spread out to eight 0/1 cells (little-endian), see store()
+        constexpr std::array<std::uint64_t, 256> makeUnpackTable()
+        {
+            std::array<std::uint64_t, 256> table{};
+            for (std::size_t value{ 0 }; value < table.size(); ++value)
+            {
+                for (std::size_t bit{ 0 }; bit < 8; ++bit)
+                {
+                    table[value] |= (((value >> bit) & 1) << (bit * 8));
+                }
+            }
+
+            return table;
+        }
+
+        constexpr std::array<std::uint64_t, 256> unpack_table{ makeUnpackTable() };
+
+        // unpackRow() memcpy()s the table's words into cells, which only puts the lowest bit's
+        // cell first on little-endian machines
+        static_assert(
+            std::endian::native == std::endian::little,
+            "unpack_table needs a little-endian machine, so unpack byte by byte instead.");
+
+    } // namespace
+
+    void packRow(
+        const CellType_t * const t_cells, const std::size_t t_width, Word_t * const t_words)
+    {
+        for (std::size_t begin{ 0 }; begin < t_width; begin += bits_per_word)
+        {
+            const std::size_t count{ std::min(bits_per_word, (t_width - begin)) };
+
+            Word_t word{ 0 };
+            for (std::size_t bit{ 0 }; bit < count; ++bit)
+            {
+                word |= (static_cast<Word_t>(t_cells[begin + bit] != 0) << bit);
+            }
+
+            t_words[begin / bits_per_word] = word;
+        }
+    }
+
+    void unpackRow(
+        const Word_t * const t_words, const std::size_t t_width, CellType_t * const t_cells)
+    {
+        for (std::size_t begin{ 0 }; begin < t_width; begin += bits_per_word)
+        {
+            const std::size_t count{ std::min(bits_per_word, (t_width - begin)) };
+            const Word_t word{ t_words[begin / bits_per_word] };
+
+            // most words of a typical board are empty
+            if (0 == word)
+            {
+                std::fill_n((t_cells + begin), count, CellType_t{ 0 });
+                continue;
+            }
+
+            // eight cells at a time when the whole byte is on the board
+            std::size_t bit{ 0 };
+            for (; (bit + 8) <= count; bit += 8)
+            {
+                const std::uint64_t spread{ unpack_table[(word >> bit) & 0xFF] };
+                std::memcpy((t_cells + begin + bit), &spread, sizeof(spread));
+            }
+
+            for (; bit < count; ++bit)
+            {
+                t_cells[begin + bit] = static_cast<CellType_t>((word >> bit) & 1);
+            }
+        }
+    }
+
+} // namespace gameoflife
@@ -0,0 +1,321 @@
+#ifndef BIT_KERNEL_HPP_INCLUDED
+#define BIT_KERNEL_HPP_INCLUDED
+//
+// bit-kernel.hpp
+//
+#include "cell-buffer.hpp"
+#include "rule.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace gameoflife
+{
+
+    // 64 cells, bit n is the cell n to the right of bit 0
+    using Word_t = std::uint64_t;
+
+    constexpr std::size_t bits_per_word{ 64 };
+
+    // What the kernel needs to see past either end of a row that wraps around:  the last cell
+    // in the top bit of the word before the row, and the first cell right after the last cell,
+    // which is either in the unused bits of the last word or in bit 0 of the word after the row.
+    struct RowGhosts
+    {
+        Word_t before{ 0 };
+        Word_t inLast{ 0 };
+        Word_t after{ 0 };
+    };
+
+    inline RowGhosts wrapRow(const Word_t * const t_row, const std::size_t t_width)
+    {
+        const std::size_t lastX{ t_width - 1 };
+        const std::size_t usedBits{ t_width % bits_per_word };
+
+        const Word_t lastCell{ (t_row[lastX / bits_per_word] >> (lastX % bits_per_word)) & 1 };
+        const Word_t firstCell{ t_row[0] & 1 };
+
+        RowGhosts ghosts;
+        ghosts.before = (lastCell << (bits_per_word - 1));
+        ghosts.inLast = ((usedBits == 0) ? 0 : (firstCell << usedBits));
+        ghosts.after  = ((usedBits == 0) ? firstCell : 0);
+        return ghosts;
+    }
+
+    // between t_width 0/1 cells and ((t_width + 63) / 64) words, the unused bits are zero
+    void packRow(
+        const CellType_t * const t_cells, const std::size_t t_width, Word_t * const t_words);
+
+    void unpackRow(
+        const Word_t * const t_words, const std::size_t t_width, CellType_t * const t_cells);
+
+    inline void halfAdd(const Word_t t_a, const Word_t t_b, Word_t & t_sum, Word_t & t_carry)
+    {
+        t_sum   = (t_a ^ t_b);
+        t_carry = (t_a & t_b);
+    }
+
+    inline void fullAdd(
+        const Word_t t_a, const Word_t t_b, const Word_t t_c, Word_t & t_sum, Word_t & t_carry)
+    {
+        const Word_t partial{ t_a ^ t_b };
+        t_sum   = (partial ^ t_c);
+        t_carry = ((t_a & t_b) | (partial & t_c));
+    }
+
+    // the three words are the previous, current, and next word of the same row
+    inline Word_t westOf(const Word_t t_prev, const Word_t t_word)
+    {
+        return ((t_word << 1) | (t_prev >> (bits_per_word - 1)));
+    }
+
+    inline Word_t eastOf(const Word_t t_word, const Word_t t_next)
+    {
+        return ((t_word >> 1) | (t_next << (bits_per_word - 1)));
+    }
+
+    // how many of its eight neighbours are alive for each of 64 cells, as bit planes where the
+    // count is ones + (2 * twos) + (4 * foursA) + (4 * foursB)
+    struct NeighbourCount
+    {
+        Word_t ones;
+        Word_t twos;
+        Word_t foursA;
+        Word_t foursB;
+    };
+
+    // given the word and the eight words around it
+    inline NeighbourCount countNeighbours(
+        const Word_t t_abovePrev,
+        const Word_t t_above,
+        const Word_t t_aboveNext,
+        const Word_t t_prev,
+        const Word_t t_word,
+        const Word_t t_next,
+        const Word_t t_belowPrev,
+        const Word_t t_below,
+        const Word_t t_belowNext)
+    {
+        Word_t sumA{ 0 };
+        Word_t carryA{ 0 };
+        fullAdd(
+            westOf(t_abovePrev, t_above), t_above, eastOf(t_above, t_aboveNext), sumA, carryA);
+
+        Word_t sumB{ 0 };
+        Word_t carryB{ 0 };
+        fullAdd(
+            westOf(t_belowPrev, t_below), t_below, eastOf(t_below, t_belowNext), sumB, carryB);
+
+        Word_t sumC{ 0 };
+        Word_t carryC{ 0 };
+        halfAdd(westOf(t_prev, t_word), eastOf(t_word, t_next), sumC, carryC);
+
+        NeighbourCount count{};
+
+        Word_t carryD{ 0 };
+        fullAdd(sumA, sumB, sumC, count.ones, carryD);
+
+        Word_t partialTwos{ 0 };
+        fullAdd(carryA, carryB, carryC, partialTwos, count.foursA);
+        halfAdd(partialTwos, carryD, count.twos, count.foursB);
+
+        return count;
+    }
+
+    // every cell whose count has its bit set in t_counts
+    inline Word_t matchCounts(const NeighbourCount & t_count, const std::uint16_t t_counts)
+    {
+        // the two fours can't both be set unless the count is eight
+        const Word_t fours{ t_count.foursA ^ t_count.foursB };
+        const Word_t eights{ t_count.foursA & t_count.foursB };
+
+        Word_t matches{ 0 };
+        for (unsigned count{ 0 }; count <= 8; ++count)
+        {
+            if (((t_counts >> count) & 1) != 0)
+            {
+                matches |=
+                    (((count & 1) ? t_count.ones : ~t_count.ones) &
+                     ((count & 2) ? t_count.twos : ~t_count.twos) &
+                     ((count & 4) ? fours : ~fours) & ((count & 8) ? eights : ~eights));
+            }
+        }
+
+        return matches;
+    }
+
+    inline Word_t
+        applyRule(const Rule & t_rule, const NeighbourCount & t_count, const Word_t t_word)
+    {
+        // counts in both lists don't depend on the cell, so test those only once
+        const std::uint16_t either{ static_cast<std::uint16_t>(t_rule.birth & t_rule.survival) };
+        const std::uint16_t bornOnly{ static_cast<std::uint16_t>(t_rule.birth & ~either) };
+        const std::uint16_t survivesOnly{ static_cast<std::uint16_t>(t_rule.survival & ~either) };
+
+        Word_t next{ matchCounts(t_count, either) };
+
+        if (bornOnly != 0)
+        {
+            next |= (matchCounts(t_count, bornOnly) & ~t_word);
+        }
+
+        if (survivesOnly != 0)
+        {
+            next |= (matchCounts(t_count, survivesOnly) & t_word);
+        }
+
+        return next;
+    }
+
+    // Steps 64 cells at once, given the word and the eight words around it.  The rule is a
+    // template parameter so the count matching above can be folded down at compile time.
+    template <Rule t_rule>
+    inline Word_t stepWord(
+        const Word_t t_abovePrev,
+        const Word_t t_above,
+        const Word_t t_aboveNext,
+        const Word_t t_prev,
+        const Word_t t_word,
+        const Word_t t_next,
+        const Word_t t_belowPrev,
+        const Word_t t_below,
+        const Word_t t_belowNext)
+    {
+        const NeighbourCount count{ countNeighbours(
+            t_abovePrev,
+            t_above,
+            t_aboveNext,
+            t_prev,
+            t_word,
+            t_next,
+            t_belowPrev,
+            t_below,
+            t_belowNext) };
+
+        if constexpr (t_rule == conway_rule)
+        {
+            // alive next if the count is three, or if the count is two and already alive
+            return (count.twos & ~(count.foursA | count.foursB) & (count.ones | t_word));
+        }
+        else
+        {
+            return applyRule(t_rule, count, t_word);
+        }
+    }
+
+    // for any other rule
+    inline Word_t stepWordAnyRule(
+        const Rule & t_rule,
+        const Word_t t_abovePrev,
+        const Word_t t_above,
+        const Word_t t_aboveNext,
+        const Word_t t_prev,
+        const Word_t t_word,
+        const Word_t t_next,
+        const Word_t t_belowPrev,
+        const Word_t t_below,
+        const Word_t t_belowNext)
+    {
+        return applyRule(
+            t_rule,
+            countNeighbours(
+                t_abovePrev,
+                t_above,
+                t_aboveNext,
+                t_prev,
+                t_word,
+                t_next,
+                t_belowPrev,
+                t_below,
+                t_belowNext),
+            t_word);
+    }
+
+    // stepWord() as function objects, so engines can write their loops as templates on these
+    template <Rule t_rule>
+    struct FixedRuleStepper
+    {
+        Word_t operator()(
+            const Word_t t_abovePrev,
+            const Word_t t_above,
+            const Word_t t_aboveNext,
+            const Word_t t_prev,
+            const Word_t t_word,
+            const Word_t t_next,
+            const Word_t t_belowPrev,
+            const Word_t t_below,
+            const Word_t t_belowNext) const
+        {
+            return stepWord<t_rule>(
+                t_abovePrev,
+                t_above,
+                t_aboveNext,
+                t_prev,
+                t_word,
+                t_next,
+                t_belowPrev,
+                t_below,
+                t_belowNext);
+        }
+    };
+
+    struct AnyRuleStepper
+    {
+        Rule rule;
+
+        Word_t operator()(
+            const Word_t t_abovePrev,
+            const Word_t t_above,
+            const Word_t t_aboveNext,
+            const Word_t t_prev,
+            const Word_t t_word,
+            const Word_t t_next,
+            const Word_t t_belowPrev,
+            const Word_t t_below,
+            const Word_t t_belowNext) const
+        {
+            return stepWordAnyRule(
+                rule,
+                t_abovePrev,
+                t_above,
+                t_aboveNext,
+                t_prev,
+                t_word,
+                t_next,
+                t_belowPrev,
+                t_below,
+                t_belowNext);
+        }
+    };
+
+    // Calls t_func once with the stepper for t_rule, which is a compiled-in kernel for the
+    // common rules and the generic one for everything else.  Since t_func is a template, the
+    // common rules get their own copy of the whole loop and not just of the kernel.
+    template <typename Func_t>
+    void withWordStepper(const Rule & t_rule, Func_t && t_func)
+    {
+        if (t_rule == conway_rule)
+        {
+            t_func(FixedRuleStepper<conway_rule>{});
+        }
+        else if (t_rule == highlife_rule)
+        {
+            t_func(FixedRuleStepper<highlife_rule>{});
+        }
+        else if (t_rule == seeds_rule)
+        {
+            t_func(FixedRuleStepper<seeds_rule>{});
+        }
+        else if (t_rule == day_and_night_rule)
+        {
+            t_func(FixedRuleStepper<day_and_night_rule>{});
+        }
+        else
+        {
+            t_func(AnyRuleStepper{ t_rule });
+        }
+    }
+
+} // namespace gameoflife
+
+#endif // BIT_KERNEL_HPP_INCLUDED
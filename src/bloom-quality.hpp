@@ -0,0 +1,32 @@
+#ifndef BLOOM_QUALITY_HPP_INCLUDED
+#define BLOOM_QUALITY_HPP_INCLUDED
+//
+// bloom-quality.hpp
+//
+#include <string_view>
+
+namespace util
+{
+    // apart from Off these all cost a bright filter and a final add at full size
+    enum class BloomQuality
+    {
+        Off,
+        Low,    // a dual filter blur down to quarter size and back up, a handful of cheap passes
+        Medium, // the same but down to eighth size, so the glow spreads twice as far
+        High    // a Gaussian blur at half and quarter size, blurMultiPassCount() times each
+    };
+
+    inline std::string_view toString(const BloomQuality quality)
+    {
+        switch (quality)
+        {
+            case BloomQuality::Off: return "off";
+            case BloomQuality::Low: return "low";
+            case BloomQuality::Medium: return "medium";
+            case BloomQuality::High:
+            default: return "high";
+        }
+    }
+} // namespace util
+
+#endif // BLOOM_QUALITY_HPP_INCLUDED
@@ -3,12 +3,19 @@
 //
 // bloom_shader.hpp
 //
+#include "bloom-quality.hpp"
+#include "frame-bloom.hpp"
+
 #include <algorithm>
 #include <array>
 #include <cmath>
+#include <cstdint>
 #include <iostream>
+#include <memory>
 #include <sstream>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include <SFML/Graphics.hpp>
 
@@ -236,19 +243,95 @@ void main()\
 
     //
 
+    // The down half of a dual filter blur (Kawase), five taps between texels so the bilinear
+    // filtering averages four texels each.  Halving the size every pass is what spreads it.
+    struct DualDownSampleShader : public FullPassFragmentShader
+    {
+        DualDownSampleShader()
+            : FullPassFragmentShader(m_fragmentShaderCode)
+        {}
+
+        void apply(const sf::RenderTexture & input, sf::RenderTexture & output)
+        {
+            setUniform("source", input.getTexture());
+            const sf::Vector2f size(input.getSize());
+            setUniform("halfPixel", sf::Vector2f((0.5f / size.x), (0.5f / size.y)));
+            draw(output);
+            output.display();
+        }
+
+        static inline const std::string m_fragmentShaderCode{ "\
+uniform sampler2D 	source;\
+uniform vec2 		halfPixel;\
+\
+void main()\
+{\
+    vec2 textureCoordinates = gl_TexCoord[0].xy;\
+    vec4 color = texture2D(source, textureCoordinates) * 4.0;\
+    color += texture2D(source, textureCoordinates - halfPixel);\
+    color += texture2D(source, textureCoordinates + halfPixel);\
+    color += texture2D(source, textureCoordinates + vec2(halfPixel.x, -halfPixel.y));\
+    color += texture2D(source, textureCoordinates - vec2(halfPixel.x, -halfPixel.y));\
+    gl_FragColor = color / 8.0;\
+}" };
+    };
+
+    //
+
+    // the up half of a dual filter blur, eight taps in a diamond around each texel
+    struct DualUpSampleShader : public FullPassFragmentShader
+    {
+        DualUpSampleShader()
+            : FullPassFragmentShader(m_fragmentShaderCode)
+        {}
+
+        void apply(const sf::RenderTexture & input, sf::RenderTexture & output)
+        {
+            setUniform("source", input.getTexture());
+            const sf::Vector2f size(input.getSize());
+            setUniform("halfPixel", sf::Vector2f((0.5f / size.x), (0.5f / size.y)));
+            draw(output);
+            output.display();
+        }
+
+        static inline const std::string m_fragmentShaderCode{ "\
+uniform sampler2D 	source;\
+uniform vec2 		halfPixel;\
+\
+void main()\
+{\
+    vec2 textureCoordinates = gl_TexCoord[0].xy;\
+    vec4 color = texture2D(source, textureCoordinates + vec2(-2.0 * halfPixel.x, 0.0));\
+    color += texture2D(source, textureCoordinates + vec2(2.0 * halfPixel.x, 0.0));\
+    color += texture2D(source, textureCoordinates + vec2(0.0, -2.0 * halfPixel.y));\
+    color += texture2D(source, textureCoordinates + vec2(0.0, 2.0 * halfPixel.y));\
+    color += texture2D(source, textureCoordinates + vec2(-halfPixel.x, halfPixel.y)) * 2.0;\
+    color += texture2D(source, textureCoordinates + vec2(halfPixel.x, halfPixel.y)) * 2.0;\
+    color += texture2D(source, textureCoordinates + vec2(halfPixel.x, -halfPixel.y)) * 2.0;\
+    color += texture2D(source, textureCoordinates + vec2(-halfPixel.x, -halfPixel.y)) * 2.0;\
+    gl_FragColor = color / 12.0;\
+}" };
+    };
+
+    //
+
     class BloomEffect
     {
         typedef std::array<sf::RenderTexture, 2> RenderTextureArray;
 
       public:
         BloomEffect()
-            : m_addShader()
+            : m_quality(BloomQuality::High)
+            , m_addShader()
             , m_blurShader()
             , m_downSampleShader()
             , m_brightFilterShader()
+            , m_dualDownSampleShader()
+            , m_dualUpSampleShader()
             , m_brightnessTexture()
             , m_halfSizeTextures()
             , m_quarterSizeTextures()
+            , m_eighthSizeTexture()
         {}
 
         static bool isSupported() { return sf::Shader::isAvailable(); }
@@ -258,6 +341,56 @@ void main()\
         {
             setupRenderTextures(input.getSize());
 
+            switch (m_quality)
+            {
+                case BloomQuality::Off:
+                {
+                    // just a copy, BloomEffectHelper skips all of this instead
+                    output.draw(sf::Sprite(input.getTexture()), sf::RenderStates(sf::BlendNone));
+                    break;
+                }
+                case BloomQuality::Low:
+                case BloomQuality::Medium:
+                {
+                    applyDualFilter(input, output);
+                    break;
+                }
+                case BloomQuality::High:
+                default:
+                {
+                    applyGaussian(input, output);
+                    break;
+                }
+            }
+        }
+
+        BloomQuality quality() const { return m_quality; }
+        void quality(const BloomQuality newQuality) { m_quality = newQuality; }
+
+        std::size_t blurMultiPassCount() const { return m_blurShader.multiPassCount(); }
+        void blurMultiPassCount(const std::size_t count) { m_blurShader.multiPassCount(count); }
+
+      private:
+        // a handful of passes, the bright filter already at half size and never more than two
+        // at each smaller size
+        void applyDualFilter(const sf::RenderTexture & input, sf::RenderTarget & output)
+        {
+            m_brightFilterShader.apply(input, m_halfSizeTextures[0]);
+            m_dualDownSampleShader.apply(m_halfSizeTextures[0], m_quarterSizeTextures[0]);
+
+            if (m_quality == BloomQuality::Medium)
+            {
+                m_dualDownSampleShader.apply(m_quarterSizeTextures[0], m_eighthSizeTexture);
+                m_dualUpSampleShader.apply(m_eighthSizeTexture, m_quarterSizeTextures[0]);
+            }
+
+            m_dualUpSampleShader.apply(m_quarterSizeTextures[0], m_halfSizeTextures[0]);
+            m_addShader.apply(input, m_halfSizeTextures[0], output);
+        }
+
+        // dozens of passes at half and quarter size with the default blurMultiPassCount()
+        void applyGaussian(const sf::RenderTexture & input, sf::RenderTarget & output)
+        {
             m_brightFilterShader.apply(input, m_brightnessTexture);
 
             m_downSampleShader.apply(m_brightnessTexture, m_halfSizeTextures[0]);
@@ -274,10 +407,6 @@ void main()\
             m_addShader.apply(input, m_halfSizeTextures[1], output);
         }
 
-        std::size_t blurMultiPassCount() const { return m_blurShader.multiPassCount(); }
-        void blurMultiPassCount(const std::size_t count) { m_blurShader.multiPassCount(count); }
-
-      private:
         // calling this every time could thrash sf::RenderTextures.  You have been warned.
         void setupRenderTextures(const sf::Vector2u & size)
         {
@@ -290,6 +419,9 @@ void main()\
             const sf::Vector2u quarterSize((size.x / 4), (size.y / 4));
             createRenderTexture(m_quarterSizeTextures[0], quarterSize);
             createRenderTexture(m_quarterSizeTextures[1], quarterSize);
+
+            const sf::Vector2u eighthSize((size.x / 8), (size.y / 8));
+            createRenderTexture(m_eighthSizeTexture, eighthSize);
         }
 
         void createRenderTexture(sf::RenderTexture & renderTexture, const sf::Vector2u & size)
@@ -310,14 +442,19 @@ void main()\
         }
 
       private:
+        BloomQuality m_quality;
+
         AddShader m_addShader;
         BlurShader m_blurShader;
         DownSampleShader m_downSampleShader;
         BrightFilterShader m_brightFilterShader;
+        DualDownSampleShader m_dualDownSampleShader;
+        DualUpSampleShader m_dualUpSampleShader;
 
         sf::RenderTexture m_brightnessTexture;
         RenderTextureArray m_halfSizeTextures;
         RenderTextureArray m_quarterSizeTextures;
+        sf::RenderTexture m_eighthSizeTexture; // only BloomQuality::Medium uses it
     };
 
     //
@@ -325,17 +462,41 @@ void main()\
     class BloomEffectHelper
     {
       public:
-        explicit BloomEffectHelper(sf::RenderWindow & window)
+        // Without shaders the glow is done by fallbackPtr on a copy of each frame read back from
+        // the video card instead, which is slower but looks about the same.  fallbackPtr is
+        // ignored when there are shaders, and is required when there aren't.
+        explicit BloomEffectHelper(
+            sf::RenderWindow & window, std::unique_ptr<IFrameBloom> fallbackPtr = {})
             : m_isEnabled(false)
-            , m_bloomEffect()
+            , m_quality(BloomQuality::High)
+            , m_blurMultiPassCount(2)
+            , m_bloomEffectPtr()
+            , m_frameBloomPtr()
             , m_window(window)
             , m_sideTexture({ window.getSize().x, window.getSize().y })
+            , m_cpuTexture()
+            , m_cpuPixels()
         {
-            if (!m_bloomEffect.isSupported())
+            if (BloomEffect::isSupported())
+            {
+                m_bloomEffectPtr = std::make_unique<BloomEffect>();
+                m_bloomEffectPtr->quality(m_quality);
+                m_bloomEffectPtr->blurMultiPassCount(m_blurMultiPassCount);
+            }
+            else if (fallbackPtr)
+            {
+                std::cerr << "No shaders on this video card, so the bloom is done on the CPU."
+                          << std::endl;
+
+                m_frameBloomPtr = std::move(fallbackPtr);
+                m_frameBloomPtr->quality(m_quality);
+                m_frameBloomPtr->blurMultiPassCount(m_blurMultiPassCount);
+            }
+            else
             {
                 throw std::runtime_error(
-                    "BloomEffectHelper's constructor just found out that sfml "
-                    "shaders are not supported on your shitty video card.");
+                    "BloomEffectHelper's constructor found that shaders are not supported on "
+                    "this video card, and was not given a fallback.");
             }
         }
 
@@ -357,11 +518,37 @@ void main()\
         bool isEnabled() const { return (m_isEnabled && isOpen()); }
         void isEnabled(const bool willEnable) { m_isEnabled = (willEnable && isOpen()); }
 
-        std::size_t blurMultipassCount() const { return m_bloomEffect.blurMultiPassCount(); }
+        // Off is the same as isEnabled(false), and without shaders the fallback does the others
+        BloomQuality quality() const { return m_quality; }
+
+        void quality(const BloomQuality newQuality)
+        {
+            m_quality = newQuality;
+            if (m_bloomEffectPtr)
+            {
+                m_bloomEffectPtr->quality(newQuality);
+            }
+            else
+            {
+                m_frameBloomPtr->quality(newQuality);
+            }
+
+            isEnabled(newQuality != BloomQuality::Off);
+        }
+
+        std::size_t blurMultipassCount() const { return m_blurMultiPassCount; }
 
         void blurMultipassCount(const std::size_t newCount)
         {
-            m_bloomEffect.blurMultiPassCount(newCount);
+            m_blurMultiPassCount = newCount;
+            if (m_bloomEffectPtr)
+            {
+                m_bloomEffectPtr->blurMultiPassCount(newCount);
+            }
+            else
+            {
+                m_frameBloomPtr->blurMultiPassCount(newCount);
+            }
         }
 
         void clear(const sf::Color & color = sf::Color::Black) { renderTarget().clear(color); }
@@ -373,12 +560,15 @@ void main()\
 
         void display()
         {
-            if (m_isEnabled)
-            {
-                m_sideTexture.display();
-                m_bloomEffect.apply(m_sideTexture, m_window);
-            }
+            applyBloom();
+            m_window.display();
+        }
 
+        // overlay is drawn over the bloom so it doesn't glow
+        void display(const sf::Drawable & overlay, const sf::RenderStates & states = {})
+        {
+            applyBloom();
+            m_window.draw(overlay, states);
             m_window.display();
         }
 
@@ -394,11 +584,58 @@ void main()\
             }
         }
 
+      private:
+        void applyBloom()
+        {
+            if (!m_isEnabled)
+            {
+                return;
+            }
+
+            m_sideTexture.display();
+
+            if (m_bloomEffectPtr)
+            {
+                m_bloomEffectPtr->apply(m_sideTexture, m_window);
+            }
+            else
+            {
+                applyOnCpu();
+            }
+        }
+
+        void applyOnCpu()
+        {
+            const sf::Image frame(m_sideTexture.getTexture().copyToImage());
+            const sf::Vector2u size(frame.getSize());
+
+            if (m_cpuTexture.getSize() != size)
+            {
+                if (!m_cpuTexture.resize(size))
+                {
+                    throw std::runtime_error(
+                        "BloomEffectHelper::applyOnCpu() failed because sf::Texture::resize() "
+                        "call failed.");
+                }
+            }
+
+            m_cpuPixels.resize(static_cast<std::size_t>(size.x) * size.y * 4);
+            m_frameBloomPtr->apply(frame.getPixelsPtr(), m_cpuPixels.data(), size);
+            m_cpuTexture.update(m_cpuPixels.data());
+
+            m_window.draw(sf::Sprite(m_cpuTexture), sf::RenderStates(sf::BlendNone));
+        }
+
       private:
         bool m_isEnabled;
-        BloomEffect m_bloomEffect;
+        BloomQuality m_quality;
+        std::size_t m_blurMultiPassCount;
+        std::unique_ptr<BloomEffect> m_bloomEffectPtr;  // only with shaders
+        std::unique_ptr<IFrameBloom> m_frameBloomPtr; // only without
         sf::RenderWindow & m_window;
         sf::RenderTexture m_sideTexture;
+        sf::Texture m_cpuTexture;
+        std::vector<std::uint8_t> m_cpuPixels;
     };
 } // namespace util
 
@@ -0,0 +1,424 @@
+//
+// byte-kernel.cpp
+//
+#include "byte-kernel.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define GAMEOFLIFE_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+// gcc and clang only emit AVX2 instructions inside functions marked like this, msvc always can
+#if defined(GAMEOFLIFE_X86) && defined(__GNUC__)
+#define GAMEOFLIFE_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define GAMEOFLIFE_TARGET_AVX2
+#endif
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+namespace gameoflife
+{
+
+    namespace
+    {
+        // the parts of a rule that the kernels for one rule test separately, see nextCells128()
+        constexpr std::uint16_t eitherCounts(const Rule & t_rule)
+        {
+            return static_cast<std::uint16_t>(t_rule.birth & t_rule.survival);
+        }
+
+        constexpr std::uint16_t bornOnlyCounts(const Rule & t_rule)
+        {
+            return static_cast<std::uint16_t>(t_rule.birth & ~t_rule.survival);
+        }
+
+        constexpr std::uint16_t survivesOnlyCounts(const Rule & t_rule)
+        {
+            return static_cast<std::uint16_t>(t_rule.survival & ~t_rule.birth);
+        }
+
+        // unrolled at compile time into plain compares so the compiler can still vectorize
+        template <std::uint16_t t_counts, int t_count = 0>
+        inline bool isCountIn(const int t_neighbours)
+        {
+            if constexpr (t_count > 8)
+            {
+                return false;
+            }
+            else if constexpr (((t_counts >> t_count) & 1) != 0)
+            {
+                return (
+                    (t_neighbours == t_count) |
+                    isCountIn<t_counts, (t_count + 1)>(t_neighbours));
+            }
+            else
+            {
+                return isCountIn<t_counts, (t_count + 1)>(t_neighbours);
+            }
+        }
+
+        template <Rule t_rule>
+        void stepRowScalar(
+            const CellType_t * const t_above,
+            const CellType_t * const t_middle,
+            const CellType_t * const t_below,
+            CellType_t * const t_next,
+            const std::size_t t_width,
+            const Rule &)
+        {
+            const std::ptrdiff_t width{ static_cast<std::ptrdiff_t>(t_width) };
+
+            for (std::ptrdiff_t x{ 0 }; x < width; ++x)
+            {
+                const int surroundingAliveCells{ t_above[x - 1] + t_above[x] + t_above[x + 1] +
+                                                 t_middle[x - 1] + t_middle[x + 1] +
+                                                 t_below[x - 1] + t_below[x] + t_below[x + 1] };
+
+                const bool isAlive{ t_middle[x] != 0 };
+
+                t_next[x] =
+                    (isCountIn<eitherCounts(t_rule)>(surroundingAliveCells) |
+                     (isCountIn<bornOnlyCounts(t_rule)>(surroundingAliveCells) & !isAlive) |
+                     (isCountIn<survivesOnlyCounts(t_rule)>(surroundingAliveCells) & isAlive));
+            }
+        }
+
+        // Any rule, looking up bit n of the birth counts for a dead cell with n neighbours, or
+        // bit n of the survival counts (stored at bit (n + 9)) for a live one.
+        void stepRowAnyRule(
+            const CellType_t * const t_above,
+            const CellType_t * const t_middle,
+            const CellType_t * const t_below,
+            CellType_t * const t_next,
+            const std::size_t t_width,
+            const Rule & t_rule)
+        {
+            const unsigned table{ t_rule.birth | (unsigned{ t_rule.survival } << 9) };
+            const std::ptrdiff_t width{ static_cast<std::ptrdiff_t>(t_width) };
+
+            for (std::ptrdiff_t x{ 0 }; x < width; ++x)
+            {
+                const unsigned surroundingAliveCells{ static_cast<unsigned>(
+                    t_above[x - 1] + t_above[x] + t_above[x + 1] + t_middle[x - 1] +
+                    t_middle[x + 1] + t_below[x - 1] + t_below[x] + t_below[x + 1]) };
+
+                t_next[x] = static_cast<CellType_t>(
+                    (table >> (surroundingAliveCells + (t_middle[x] * 9u))) & 1u);
+            }
+        }
+
+#if defined(GAMEOFLIFE_X86)
+
+        // memcpy instead of casting to __m128i/__m256i pointers because the rows are unaligned
+        inline __m128i load128(const CellType_t * const t_source)
+        {
+            __m128i value;
+            std::memcpy(&value, t_source, sizeof(value));
+            return value;
+        }
+
+        inline void store128(CellType_t * const t_destination, const __m128i t_value)
+        {
+            std::memcpy(t_destination, &t_value, sizeof(t_value));
+        }
+
+        // 0xFF for every byte of t_count that has its bit set in t_counts, all at compile time
+        template <std::uint16_t t_counts, int t_count = 0>
+        inline __m128i matchCounts128(const __m128i t_neighbours)
+        {
+            if constexpr (t_count > 8)
+            {
+                return _mm_setzero_si128();
+            }
+            else
+            {
+                const __m128i others{ matchCounts128<t_counts, (t_count + 1)>(t_neighbours) };
+
+                if constexpr (((t_counts >> t_count) & 1) != 0)
+                {
+                    return _mm_or_si128(
+                        others, _mm_cmpeq_epi8(t_neighbours, _mm_set1_epi8(t_count)));
+                }
+                else
+                {
+                    return others;
+                }
+            }
+        }
+
+        // For B3/S23 this is (count == 3) | ((count == 2) & middle), just like a kernel written
+        // only for Conway's rule, so supporting other rules costs Conway nothing.
+        template <Rule t_rule>
+        inline __m128i nextCells128(const __m128i t_neighbours, const __m128i t_middle)
+        {
+            const __m128i ones{ _mm_set1_epi8(1) };
+
+            __m128i next{ _mm_and_si128(
+                matchCounts128<eitherCounts(t_rule)>(t_neighbours), ones) };
+
+            if constexpr (bornOnlyCounts(t_rule) != 0)
+            {
+                // the and with ones clears what the andnot leaves of the live cells
+                const __m128i born{ _mm_andnot_si128(
+                    t_middle, matchCounts128<bornOnlyCounts(t_rule)>(t_neighbours)) };
+
+                next = _mm_or_si128(next, _mm_and_si128(born, ones));
+            }
+
+            if constexpr (survivesOnlyCounts(t_rule) != 0)
+            {
+                next = _mm_or_si128(
+                    next,
+                    _mm_and_si128(
+                        matchCounts128<survivesOnlyCounts(t_rule)>(t_neighbours), t_middle));
+            }
+
+            return next;
+        }
+
+        template <Rule t_rule>
+        void stepRowSse2(
+            const CellType_t * const t_above,
+            const CellType_t * const t_middle,
+            const CellType_t * const t_below,
+            CellType_t * const t_next,
+            const std::size_t t_width,
+            const Rule & t_unused)
+        {
+            std::size_t x{ 0 };
+            for (; (x + 16) <= t_width; x += 16)
+            {
+                // cells are zero or one so eight of them added never overflow a byte
+                __m128i count{ _mm_add_epi8(load128(t_above + x - 1), load128(t_above + x)) };
+                count = _mm_add_epi8(count, load128(t_above + x + 1));
+                count = _mm_add_epi8(count, load128(t_middle + x - 1));
+                count = _mm_add_epi8(count, load128(t_middle + x + 1));
+                count = _mm_add_epi8(count, load128(t_below + x - 1));
+                count = _mm_add_epi8(count, load128(t_below + x));
+                count = _mm_add_epi8(count, load128(t_below + x + 1));
+
+                store128((t_next + x), nextCells128<t_rule>(count, load128(t_middle + x)));
+            }
+
+            // the last (width % 16) cells
+            stepRowScalar<t_rule>(
+                (t_above + x),
+                (t_middle + x),
+                (t_below + x),
+                (t_next + x),
+                (t_width - x),
+                t_unused);
+        }
+
+        GAMEOFLIFE_TARGET_AVX2 inline __m256i load256(const CellType_t * const t_source)
+        {
+            __m256i value;
+            std::memcpy(&value, t_source, sizeof(value));
+            return value;
+        }
+
+        GAMEOFLIFE_TARGET_AVX2 inline void
+            store256(CellType_t * const t_destination, const __m256i t_value)
+        {
+            std::memcpy(t_destination, &t_value, sizeof(t_value));
+        }
+
+        template <std::uint16_t t_counts, int t_count = 0>
+        GAMEOFLIFE_TARGET_AVX2 inline __m256i matchCounts256(const __m256i t_neighbours)
+        {
+            if constexpr (t_count > 8)
+            {
+                return _mm256_setzero_si256();
+            }
+            else
+            {
+                const __m256i others{ matchCounts256<t_counts, (t_count + 1)>(t_neighbours) };
+
+                if constexpr (((t_counts >> t_count) & 1) != 0)
+                {
+                    return _mm256_or_si256(
+                        others, _mm256_cmpeq_epi8(t_neighbours, _mm256_set1_epi8(t_count)));
+                }
+                else
+                {
+                    return others;
+                }
+            }
+        }
+
+        template <Rule t_rule>
+        GAMEOFLIFE_TARGET_AVX2 inline __m256i
+            nextCells256(const __m256i t_neighbours, const __m256i t_middle)
+        {
+            const __m256i ones{ _mm256_set1_epi8(1) };
+
+            __m256i next{ _mm256_and_si256(
+                matchCounts256<eitherCounts(t_rule)>(t_neighbours), ones) };
+
+            if constexpr (bornOnlyCounts(t_rule) != 0)
+            {
+                const __m256i born{ _mm256_andnot_si256(
+                    t_middle, matchCounts256<bornOnlyCounts(t_rule)>(t_neighbours)) };
+
+                next = _mm256_or_si256(next, _mm256_and_si256(born, ones));
+            }
+
+            if constexpr (survivesOnlyCounts(t_rule) != 0)
+            {
+                next = _mm256_or_si256(
+                    next,
+                    _mm256_and_si256(
+                        matchCounts256<survivesOnlyCounts(t_rule)>(t_neighbours), t_middle));
+            }
+
+            return next;
+        }
+
+        template <Rule t_rule>
+        GAMEOFLIFE_TARGET_AVX2 void stepRowAvx2(
+            const CellType_t * const t_above,
+            const CellType_t * const t_middle,
+            const CellType_t * const t_below,
+            CellType_t * const t_next,
+            const std::size_t t_width,
+            const Rule & t_unused)
+        {
+            std::size_t x{ 0 };
+            for (; (x + 32) <= t_width; x += 32)
+            {
+                __m256i count{ _mm256_add_epi8(load256(t_above + x - 1), load256(t_above + x)) };
+                count = _mm256_add_epi8(count, load256(t_above + x + 1));
+                count = _mm256_add_epi8(count, load256(t_middle + x - 1));
+                count = _mm256_add_epi8(count, load256(t_middle + x + 1));
+                count = _mm256_add_epi8(count, load256(t_below + x - 1));
+                count = _mm256_add_epi8(count, load256(t_below + x));
+                count = _mm256_add_epi8(count, load256(t_below + x + 1));
+
+                store256((t_next + x), nextCells256<t_rule>(count, load256(t_middle + x)));
+            }
+
+            // the last (width % 32) cells
+            stepRowSse2<t_rule>(
+                (t_above + x),
+                (t_middle + x),
+                (t_below + x),
+                (t_next + x),
+                (t_width - x),
+                t_unused);
+        }
+
+        SimdLevel askCpuForSimdLevel()
+        {
+#if defined(_MSC_VER)
+            int registers[4]{};
+
+            __cpuid(registers, 0);
+            const int highestLeaf{ registers[0] };
+
+            __cpuid(registers, 1);
+            const bool hasSse2{ (registers[3] & (1 << 26)) != 0 };
+            const bool hasOsxsave{ (registers[2] & (1 << 27)) != 0 };
+
+            // the OS must also save the AVX registers on context switches
+            bool hasAvx2{ false };
+            if (hasOsxsave && (highestLeaf >= 7) && ((_xgetbv(0) & 0x6) == 0x6))
+            {
+                __cpuidex(registers, 7, 0);
+                hasAvx2 = ((registers[1] & (1 << 5)) != 0);
+            }
+#else
+            __builtin_cpu_init();
+            const bool hasSse2{ __builtin_cpu_supports("sse2") != 0 };
+            const bool hasAvx2{ __builtin_cpu_supports("avx2") != 0 };
+#endif
+
+            if (hasAvx2)
+            {
+                return SimdLevel::Avx2;
+            }
+            else if (hasSse2)
+            {
+                return SimdLevel::Sse2;
+            }
+            else
+            {
+                return SimdLevel::Scalar;
+            }
+        }
+
+#endif // GAMEOFLIFE_X86
+
+        template <Rule t_rule>
+        RowKernel_t selectFixedRuleKernel(const SimdLevel t_maxLevel)
+        {
+#if defined(GAMEOFLIFE_X86)
+            const SimdLevel level{ std::min(t_maxLevel, detectSimdLevel()) };
+
+            if (SimdLevel::Avx2 == level)
+            {
+                return &stepRowAvx2<t_rule>;
+            }
+            else if (SimdLevel::Sse2 == level)
+            {
+                return &stepRowSse2<t_rule>;
+            }
+#else
+            static_cast<void>(t_maxLevel);
+#endif
+
+            return &stepRowScalar<t_rule>;
+        }
+    } // namespace
+
+    std::string_view toString(const SimdLevel t_level)
+    {
+        switch (t_level)
+        {
+            case SimdLevel::Avx2: return "avx2";
+            case SimdLevel::Sse2: return "sse2";
+            case SimdLevel::Scalar:
+            default: return "scalar";
+        }
+    }
+
+    SimdLevel detectSimdLevel()
+    {
+#if defined(GAMEOFLIFE_X86)
+        static const SimdLevel level{ askCpuForSimdLevel() };
+        return level;
+#else
+        return SimdLevel::Scalar;
+#endif
+    }
+
+    RowKernel_t selectRowKernel(const SimdLevel t_maxLevel, const Rule & t_rule)
+    {
+        if (t_rule == conway_rule)
+        {
+            return selectFixedRuleKernel<conway_rule>(t_maxLevel);
+        }
+        else if (t_rule == highlife_rule)
+        {
+            return selectFixedRuleKernel<highlife_rule>(t_maxLevel);
+        }
+        else if (t_rule == seeds_rule)
+        {
+            return selectFixedRuleKernel<seeds_rule>(t_maxLevel);
+        }
+        else if (t_rule == day_and_night_rule)
+        {
+            return selectFixedRuleKernel<day_and_night_rule>(t_maxLevel);
+        }
+        else
+        {
+            return &stepRowAnyRule;
+        }
+    }
+
+} // namespace gameoflife
@@ -0,0 +1,45 @@
+#ifndef BYTE_KERNEL_HPP_INCLUDED
+#define BYTE_KERNEL_HPP_INCLUDED
+//
+// byte-kernel.hpp
+//
+#include "cell-buffer.hpp"
+#include "rule.hpp"
+
+#include <cstddef>
+#include <string_view>
+
+namespace gameoflife
+{
+
+    enum class SimdLevel
+    {
+        Scalar,
+        Sse2, // 16 cells at a time
+        Avx2  // 32 cells at a time
+    };
+
+    std::string_view toString(const SimdLevel t_level);
+
+    // what this CPU (and OS) supports, only asks CPUID the first time
+    SimdLevel detectSimdLevel();
+
+    // Steps one row of a CellBuffer into the same row of another.  The three source rows must
+    // be readable from [-1] to [t_width] (see CellBuffer's halo) and hold only zeros and ones.
+    // Kernels built for one rule ignore t_rule, only the generic kernel looks at it.
+    using RowKernel_t = void (*)(
+        const CellType_t * const t_above,
+        const CellType_t * const t_middle,
+        const CellType_t * const t_below,
+        CellType_t * const t_next,
+        const std::size_t t_width,
+        const Rule & t_rule);
+
+    // The fastest kernel that is no higher than t_maxLevel and is supported by this CPU.  The
+    // common rules in rule.hpp have SIMD kernels built just for them, any other rule gets the
+    // generic scalar kernel.
+    RowKernel_t selectRowKernel(const SimdLevel t_maxLevel, const Rule & t_rule);
+
+} // namespace gameoflife
+
+#endif // BYTE_KERNEL_HPP_INCLUDED
@@ -0,0 +1,54 @@
+//
+// cell-buffer.cpp
+//
+#include "cell-buffer.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace gameoflife
+{
+
+    CellBuffer::CellBuffer()
+        : m_width{ 0 }
+        , m_height{ 0 }
+        , m_cells{}
+    {}
+
+    void CellBuffer::resize(const std::size_t t_width, const std::size_t t_height)
+    {
+        m_width  = t_width;
+        m_height = t_height;
+        m_cells.assign(((t_width + 2) * (t_height + 2)), 0);
+    }
+
+    void CellBuffer::clear() { std::fill(std::begin(m_cells), std::end(m_cells), CellType_t{ 0 }); }
+
+    void CellBuffer::wrapHalo()
+    {
+        if ((0 == m_width) || (0 == m_height))
+        {
+            return;
+        }
+
+        for (std::size_t y{ 0 }; y < m_height; ++y)
+        {
+            CellType_t * const cells{ row(y) };
+            cells[-1]      = cells[m_width - 1];
+            cells[m_width] = cells[0];
+        }
+
+        // whole rows including their halo cells, which wraps the corners too
+        const std::size_t lastY{ m_height - 1 };
+        std::copy_n((row(lastY) - 1), stride(), (row(0) - stride() - 1));
+        std::copy_n((row(0) - 1), stride(), (row(lastY) + stride() - 1));
+    }
+
+    void CellBuffer::swap(CellBuffer & t_other) noexcept
+    {
+        std::swap(m_width, t_other.m_width);
+        std::swap(m_height, t_other.m_height);
+        m_cells.swap(t_other.m_cells);
+    }
+
+} // namespace gameoflife
@@ -0,0 +1,65 @@
+#ifndef CELL_BUFFER_HPP_INCLUDED
+#define CELL_BUFFER_HPP_INCLUDED
+//
+// cell-buffer.hpp
+//
+#include <cstddef>
+#include <vector>
+
+namespace gameoflife
+{
+
+    using CellType_t = unsigned char;
+
+    // One byte per cell in a single contiguous block, row after row, with a one cell border of
+    // always dead "halo" cells around the whole board.  So for any cell on the board all eight
+    // neighbours can be read without checking the edges:  row(y)[-1] and row(y)[width()] are
+    // halo cells, and so are the rows at (row(0) - stride()) and (row(height() - 1) + stride()).
+    //
+    // For a board that wraps around, wrapHalo() fills the halo with copies of the cells at the
+    // opposite edges instead, so the same kernels step a torus without any extra checks.
+    class CellBuffer
+    {
+      public:
+        CellBuffer();
+
+        // all cells (and the halo) are dead afterward
+        void resize(const std::size_t t_width, const std::size_t t_height);
+        void clear();
+
+        // the halo is only wrapped until the board is next written, so call this every step
+        void wrapHalo();
+
+        std::size_t width() const { return m_width; }
+        std::size_t height() const { return m_height; }
+        std::size_t stride() const { return (m_width + 2); }
+        std::size_t byteCount() const { return (m_cells.capacity() * sizeof(CellType_t)); }
+
+        bool isPositionValid(const std::size_t t_x, const std::size_t t_y) const
+        {
+            return ((t_x < m_width) && (t_y < m_height));
+        }
+
+        // unchecked, see above for what can be reached around each row
+        CellType_t * row(const std::size_t t_y)
+        {
+            return (m_cells.data() + ((t_y + 1) * stride()) + 1);
+        }
+
+        const CellType_t * row(const std::size_t t_y) const
+        {
+            return (m_cells.data() + ((t_y + 1) * stride()) + 1);
+        }
+
+        // cheap, only swaps the underlying pointers
+        void swap(CellBuffer & t_other) noexcept;
+
+      private:
+        std::size_t m_width;
+        std::size_t m_height;
+        std::vector<CellType_t> m_cells;
+    };
+
+} // namespace gameoflife
+
+#endif // CELL_BUFFER_HPP_INCLUDED
@@ -0,0 +1,440 @@
+//
+// cell-shader.cpp
+//
+#include "cell-shader.hpp"
+
+#include <SFML/Graphics/Glsl.hpp>
+#include <SFML/Graphics/PrimitiveType.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+
+namespace gameoflife
+{
+
+    namespace
+    {
+        // in pixels on screen, any smaller and the lines and outlines would cover the cells
+        constexpr float min_outlined_cell_size{ 4.0f };
+    } // namespace
+
+    // the texture coordinates are in cells, not zero to one
+    const std::string CellShader::m_vertexShaderCode{ "\
+void main()\
+{\
+    gl_Position = gl_ModelViewProjectionMatrix * gl_Vertex;\
+    gl_TexCoord[0] = gl_MultiTexCoord0;\
+}" };
+
+    // The texture only holds the cells in view, plus one more all around where there are any,
+    // and every cell outside of it counts as dead.
+    //
+    // Each live cell used to be drawn in row order as its fill and then an outline around the
+    // outside, so a cell's outline covers the cells before it but the cells after it cover the
+    // outline.  So a pixel is outline if it is inside the outline of a live neighbour that
+    // comes later, or of any live neighbour at all if its own cell is dead.  The grid lines are
+    // underneath everything, at the top and left of every cell plus past the bottom and right.
+    const std::string CellShader::m_fragmentShaderCode{ "\
+uniform sampler2D cells;\
+uniform vec2 texturePosition;\
+uniform vec2 textureSize;\
+uniform vec2 cellCounts;\
+uniform float cellSize;\
+uniform float outlineThickness;\
+uniform float lineThickness;\
+uniform vec4 colorOn;\
+uniform vec4 colorOff;\
+uniform vec4 colorOutline;\
+\
+bool isAlive(vec2 cell)\
+{\
+    vec2 texel = cell - texturePosition;\
+    if (any(lessThan(texel, vec2(0.0))) || any(greaterThanEqual(texel, textureSize)))\
+    {\
+        return false;\
+    }\
+\
+    return (texture2D(cells, (texel + 0.5) / textureSize).r > 0.5);\
+}\
+\
+bool isInOutline(vec2 pixel, vec2 offset)\
+{\
+    vec2 low = (offset * cellSize) - outlineThickness;\
+    vec2 high = ((offset + 1.0) * cellSize) + outlineThickness;\
+    return (all(greaterThanEqual(pixel, low)) && all(lessThan(pixel, high)));\
+}\
+\
+void main()\
+{\
+    vec2 position = gl_TexCoord[0].xy;\
+    vec2 cell = floor(position);\
+    vec2 pixel = (position - cell) * cellSize;\
+    bool isCellAlive = isAlive(cell);\
+\
+    bool isOutline = false;\
+    for (int y = -1; y <= 1; ++y)\
+    {\
+        for (int x = -1; x <= 1; ++x)\
+        {\
+            bool isLater = ((y > 0) || ((y == 0) && (x > 0)));\
+            bool isOther = ((x != 0) || (y != 0));\
+            vec2 offset = vec2(float(x), float(y));\
+            if (isOther && (isLater || !isCellAlive) && isAlive(cell + offset) &&\
+                isInOutline(pixel, offset))\
+            {\
+                isOutline = true;\
+            }\
+        }\
+    }\
+\
+    bool isOnBoard = (all(greaterThanEqual(position, vec2(0.0))) &&\
+                      all(lessThan(position, cellCounts)));\
+\
+    bool isOnLine = (all(greaterThanEqual(cell, vec2(0.0))) &&\
+                     all(lessThanEqual(cell, cellCounts)) &&\
+                     (((pixel.x < lineThickness) && (position.y <= cellCounts.y)) ||\
+                      ((pixel.y < lineThickness) && (position.x <= cellCounts.x))));\
+\
+    if (isOutline || (isOnLine && !isCellAlive))\
+    {\
+        gl_FragColor = colorOutline;\
+    }\
+    else if (isCellAlive)\
+    {\
+        gl_FragColor = colorOn;\
+    }\
+    else if (isOnBoard)\
+    {\
+        gl_FragColor = colorOff;\
+    }\
+    else\
+    {\
+        discard;\
+    }\
+}" };
+
+    CellShader::CellShader()
+        : m_isShaded{ sf::Shader::isAvailable() }
+        , m_shader{}
+        , m_texture{}
+        , m_densityTexture{}
+        , m_texturePosition{}
+        , m_uploadedCells{}
+        , m_pixels{}
+    {
+        if (m_isShaded && !m_shader.loadFromMemory(m_vertexShaderCode, m_fragmentShaderCode))
+        {
+            throw std::runtime_error(
+                "CellShader could not be constructed because "
+                "sf::Shader::loadFromMemory() failed.");
+        }
+    }
+
+    void CellShader::draw(
+        const Config & t_config,
+        const CellBuffer & t_cells,
+        const CellRect_t & t_visibleCells,
+        const sf::Vector2f & t_origin,
+        const float t_cellSize,
+        sf::RenderTarget & t_target,
+        const sf::RenderStates & t_states)
+    {
+        if ((t_visibleCells.size.x == 0) || (t_visibleCells.size.y == 0))
+        {
+            return;
+        }
+
+        // one more cell all around, for the outlines of live cells just out of view
+        const std::size_t beginX{ (t_visibleCells.position.x > 0) ? (t_visibleCells.position.x - 1)
+                                                                  : 0 };
+        const std::size_t beginY{ (t_visibleCells.position.y > 0) ? (t_visibleCells.position.y - 1)
+                                                                  : 0 };
+        const std::size_t endX{ std::min(
+            t_cells.width(), (t_visibleCells.position.x + t_visibleCells.size.x + 1)) };
+        const std::size_t endY{ std::min(
+            t_cells.height(), (t_visibleCells.position.y + t_visibleCells.size.y + 1)) };
+
+        upload(t_cells, { { beginX, beginY }, { (endX - beginX), (endY - beginY) } });
+
+        if (!m_isShaded)
+        {
+            drawUnshaded(t_config, t_visibleCells, t_origin, t_cellSize, t_target, t_states);
+            return;
+        }
+
+        const bool isOutlined{ t_cellSize >= min_outlined_cell_size };
+        const float outlineThickness{ isOutlined ? t_config.grid_line_thickness : 0.0f };
+
+        m_shader.setUniform("cells", m_texture);
+        m_shader.setUniform("texturePosition", sf::Vector2f{ m_texturePosition });
+        m_shader.setUniform("textureSize", sf::Vector2f{ m_texture.getSize() });
+        m_shader.setUniform(
+            "cellCounts",
+            sf::Vector2f{ static_cast<float>(t_cells.width()),
+                          static_cast<float>(t_cells.height()) });
+        m_shader.setUniform("cellSize", t_cellSize);
+        m_shader.setUniform("outlineThickness", outlineThickness);
+        m_shader.setUniform("lineThickness", (isOutlined ? 1.0f : 0.0f));
+        m_shader.setUniform("colorOn", sf::Glsl::Vec4{ t_config.grid_color_on });
+        m_shader.setUniform("colorOff", sf::Glsl::Vec4{ t_config.grid_color_off });
+        m_shader.setUniform("colorOutline", sf::Glsl::Vec4{ t_config.grid_color_outline });
+
+        // big enough for the outlines around the edge cells and the last grid lines
+        const float marginInCells{ std::max(1.0f, outlineThickness) / t_cellSize };
+        const sf::Vector2f cellTopLeft{ sf::Vector2f{ t_visibleCells.position } -
+                                        sf::Vector2f{ marginInCells, marginInCells } };
+
+        const sf::Vector2f cellBottomRight{
+            sf::Vector2f{ t_visibleCells.position + t_visibleCells.size } +
+            sf::Vector2f{ marginInCells, marginInCells }
+        };
+
+        const sf::Vector2f topLeft{ t_origin + (cellTopLeft * t_cellSize) };
+        const sf::Vector2f bottomRight{ t_origin + (cellBottomRight * t_cellSize) };
+
+        const std::array<sf::Vertex, 4> verts{
+            sf::Vertex{ topLeft, sf::Color::White, cellTopLeft },
+            sf::Vertex{ { bottomRight.x, topLeft.y },
+                        sf::Color::White,
+                        { cellBottomRight.x, cellTopLeft.y } },
+            sf::Vertex{ { topLeft.x, bottomRight.y },
+                        sf::Color::White,
+                        { cellTopLeft.x, cellBottomRight.y } },
+            sf::Vertex{ bottomRight, sf::Color::White, cellBottomRight }
+        };
+
+        sf::RenderStates states{ t_states };
+        states.shader = &m_shader;
+
+        t_target.draw(verts.data(), verts.size(), sf::PrimitiveType::TriangleStrip, states);
+    }
+
+    void CellShader::drawUnshaded(
+        const Config & t_config,
+        const CellRect_t & t_visibleCells,
+        const sf::Vector2f & t_origin,
+        const float t_cellSize,
+        sf::RenderTarget & t_target,
+        const sf::RenderStates & t_states)
+    {
+        const sf::Vector2f topLeft{ t_origin +
+                                    (sf::Vector2f{ t_visibleCells.position } * t_cellSize) };
+
+        const sf::Vector2f bottomRight{ topLeft +
+                                        (sf::Vector2f{ t_visibleCells.size } * t_cellSize) };
+
+        // the dead cells, which are transparent in the texture
+        const sf::Color & off{ t_config.grid_color_off };
+        const std::array<sf::Vertex, 4> offVerts{
+            sf::Vertex{ topLeft, off },
+            sf::Vertex{ { bottomRight.x, topLeft.y }, off },
+            sf::Vertex{ { topLeft.x, bottomRight.y }, off },
+            sf::Vertex{ bottomRight, off }
+        };
+
+        t_target.draw(offVerts.data(), offVerts.size(), sf::PrimitiveType::TriangleStrip, t_states);
+
+        // and the live ones on top, white in the texture and so colorOn
+        const sf::Color & on{ t_config.grid_color_on };
+        const sf::Vector2f texelTopLeft{ sf::Vector2f{ t_visibleCells.position -
+                                                       m_texturePosition } };
+
+        const sf::Vector2f texelBottomRight{ texelTopLeft + sf::Vector2f{ t_visibleCells.size } };
+
+        const std::array<sf::Vertex, 4> onVerts{
+            sf::Vertex{ topLeft, on, texelTopLeft },
+            sf::Vertex{ { bottomRight.x, topLeft.y }, on, { texelBottomRight.x, texelTopLeft.y } },
+            sf::Vertex{ { topLeft.x, bottomRight.y }, on, { texelTopLeft.x, texelBottomRight.y } },
+            sf::Vertex{ bottomRight, on, texelBottomRight }
+        };
+
+        sf::RenderStates states{ t_states };
+        states.texture = &m_texture;
+
+        t_target.draw(onVerts.data(), onVerts.size(), sf::PrimitiveType::TriangleStrip, states);
+    }
+
+    void CellShader::drawDensity(
+        const Config & t_config,
+        const DensityLevel & t_level,
+        const CellRect_t & t_visibleBlocks,
+        const sf::Vector2f & t_origin,
+        const float t_blockSize,
+        sf::RenderTarget & t_target,
+        const sf::RenderStates & t_states)
+    {
+        if ((t_visibleBlocks.size.x == 0) || (t_visibleBlocks.size.y == 0))
+        {
+            return;
+        }
+
+        const sf::Vector2u size{ static_cast<unsigned>(t_visibleBlocks.size.x),
+                                 static_cast<unsigned>(t_visibleBlocks.size.y) };
+
+        if ((m_densityTexture.getSize() != size) && !m_densityTexture.resize(size))
+        {
+            throw std::runtime_error(
+                "CellShader::drawDensity() failed because sf::Texture::resize() failed.");
+        }
+
+        // Blocks are at least a pixel each, so there are never more of these than pixels on
+        // screen.  And the level changes every generation, so diffing wouldn't pay off.
+        const sf::Color & off{ t_config.grid_color_off };
+        const sf::Color & on{ t_config.grid_color_on };
+        const auto blend{ [](const unsigned t_from, const unsigned t_to, const unsigned t_density) {
+            return static_cast<std::uint8_t>(
+                ((t_from * (255u - t_density)) + (t_to * t_density) + 127u) / 255u);
+        } };
+
+        m_pixels.resize(static_cast<std::size_t>(size.x) * size.y * 4);
+
+        std::uint8_t * pixel{ m_pixels.data() };
+        for (std::size_t y{ 0 }; y < t_visibleBlocks.size.y; ++y)
+        {
+            const std::uint8_t * const densities{ t_level.row(t_visibleBlocks.position.y + y) +
+                                                  t_visibleBlocks.position.x };
+
+            for (std::size_t x{ 0 }; x < t_visibleBlocks.size.x; ++x)
+            {
+                const unsigned density{ densities[x] };
+                pixel[0] = blend(off.r, on.r, density);
+                pixel[1] = blend(off.g, on.g, density);
+                pixel[2] = blend(off.b, on.b, density);
+                pixel[3] = blend(off.a, on.a, density);
+                pixel += 4;
+            }
+        }
+
+        m_densityTexture.update(m_pixels.data());
+
+        const sf::Vector2f topLeft{ t_origin +
+                                    (sf::Vector2f{ t_visibleBlocks.position } * t_blockSize) };
+
+        const sf::Vector2f bottomRight{ topLeft + (sf::Vector2f{ size } * t_blockSize) };
+        const sf::Vector2f textureSize{ size };
+
+        const std::array<sf::Vertex, 4> verts{
+            sf::Vertex{ topLeft, sf::Color::White, { 0.0f, 0.0f } },
+            sf::Vertex{ { bottomRight.x, topLeft.y }, sf::Color::White, { textureSize.x, 0.0f } },
+            sf::Vertex{ { topLeft.x, bottomRight.y }, sf::Color::White, { 0.0f, textureSize.y } },
+            sf::Vertex{ bottomRight, sf::Color::White, textureSize }
+        };
+
+        sf::RenderStates states{ t_states };
+        states.texture = &m_densityTexture;
+
+        t_target.draw(verts.data(), verts.size(), sf::PrimitiveType::TriangleStrip, states);
+    }
+
+    void CellShader::upload(const CellBuffer & t_cells, const CellRect_t & t_rect)
+    {
+        const std::size_t width{ t_rect.size.x };
+        const std::size_t height{ t_rect.size.y };
+        const sf::Vector2u size{ static_cast<unsigned>(width), static_cast<unsigned>(height) };
+
+        if ((m_texture.getSize() != size) || (m_texturePosition != t_rect.position))
+        {
+            if ((m_texture.getSize() != size) && !m_texture.resize(size))
+            {
+                throw std::runtime_error(
+                    "CellShader::upload() failed because sf::Texture::resize() failed.");
+            }
+
+            m_texturePosition = t_rect.position;
+            m_uploadedCells.resize(width * height);
+            uploadRect(t_cells, 0, width, 0, height);
+            return;
+        }
+
+        // Runs of rows that changed go up as one rect, only as wide as the changes.  Comparing
+        // every row is far cheaper than uploading it, so the upload follows the activity on
+        // the board instead of its size.
+        std::size_t runBeginY{ 0 };
+        std::size_t runBeginX{ width };
+        std::size_t runEndX{ 0 };
+        bool isInRun{ false };
+
+        for (std::size_t y{ 0 }; y <= height; ++y)
+        {
+            bool isRowChanged{ false };
+            if (y < height)
+            {
+                const CellType_t * const row{ t_cells.row(m_texturePosition.y + y) +
+                                              m_texturePosition.x };
+
+                const CellType_t * const uploadedRow{ m_uploadedCells.data() + (y * width) };
+
+                const CellType_t * const first{
+                    std::mismatch(row, (row + width), uploadedRow).first
+                };
+
+                if (first != (row + width))
+                {
+                    // the last difference, searching backward from the end
+                    std::size_t last{ width };
+                    while (row[last - 1] == uploadedRow[last - 1])
+                    {
+                        --last;
+                    }
+
+                    runBeginX    = std::min(runBeginX, static_cast<std::size_t>(first - row));
+                    runEndX      = std::max(runEndX, last);
+                    isRowChanged = true;
+                }
+            }
+
+            if (isRowChanged && !isInRun)
+            {
+                runBeginY = y;
+                isInRun   = true;
+            }
+            else if (!isRowChanged && isInRun)
+            {
+                uploadRect(t_cells, runBeginX, runEndX, runBeginY, y);
+                runBeginX = width;
+                runEndX   = 0;
+                isInRun   = false;
+            }
+        }
+    }
+
+    void CellShader::uploadRect(
+        const CellBuffer & t_cells,
+        const std::size_t t_beginX,
+        const std::size_t t_endX,
+        const std::size_t t_beginY,
+        const std::size_t t_endY)
+    {
+        const std::size_t textureWidth{ m_texture.getSize().x };
+        const std::size_t rectWidth{ t_endX - t_beginX };
+        m_pixels.resize(rectWidth * (t_endY - t_beginY) * 4);
+
+        std::uint8_t * pixel{ m_pixels.data() };
+        for (std::size_t y{ t_beginY }; y < t_endY; ++y)
+        {
+            const CellType_t * const row{ t_cells.row(m_texturePosition.y + y) +
+                                          m_texturePosition.x };
+
+            for (std::size_t x{ t_beginX }; x < t_endX; ++x)
+            {
+                // white or transparent, only red matters to the shader
+                const std::uint8_t value{ static_cast<std::uint8_t>((row[x] == 0) ? 0 : 255) };
+                std::fill(pixel, (pixel + 4), value);
+                pixel += 4;
+            }
+
+            std::copy(
+                (row + t_beginX),
+                (row + t_endX),
+                (m_uploadedCells.data() + (y * textureWidth) + t_beginX));
+        }
+
+        m_texture.update(
+            m_pixels.data(),
+            { static_cast<unsigned>(rectWidth), static_cast<unsigned>(t_endY - t_beginY) },
+            { static_cast<unsigned>(t_beginX), static_cast<unsigned>(t_beginY) });
+    }
+
+} // namespace gameoflife
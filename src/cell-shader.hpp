@@ -0,0 +1,106 @@
+#ifndef CELL_SHADER_HPP_INCLUDED
+#define CELL_SHADER_HPP_INCLUDED
+//
+// cell-shader.hpp
+//
+#include "cell-buffer.hpp"
+#include "config.hpp"
+#include "density-pyramid.hpp"
+
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/Graphics/RenderStates.hpp>
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/Shader.hpp>
+#include <SFML/Graphics/Texture.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace gameoflife
+{
+
+    using CellRect_t = sf::Rect<std::size_t>;
+
+    // Draws the visible part of a board as one quad, so the cost doesn't grow with how many
+    // cells are alive or with how big the board is.  Those cells are uploaded to a texture with
+    // one texel each, and a fragment shader colors every pixel from that texture.  It adds the
+    // grid lines and the outlines around live cells that used to be drawn as separate lines and
+    // sf::RectangleShapes, and they look the same.  Both are left out once cells get too small
+    // on screen to see them.
+    //
+    // Only the cells that changed since the last draw are uploaded again, so on a stable board
+    // the upload costs little more than comparing against a copy of what was last sent.
+    //
+    // Zoomed out past one cell per pixel, drawDensity() shades blocks of cells from a
+    // DensityPyramid level instead, which costs about one texel per pixel on screen.
+    //
+    // Without shaders the same texture is drawn as is over a quad of colorOff instead, so the
+    // cells still show but without the grid lines or outlines.
+    //
+    // Needs an OpenGL context, so only make one once the window is open.
+    class CellShader
+    {
+      public:
+        // throws std::runtime_error if the shader won't compile
+        CellShader();
+
+        // Draws only t_visibleCells, with the top-left of cell (0,0) at t_origin on screen even
+        // if it isn't visible.  The outlines can spill a little past the visible cells.
+        void draw(
+            const Config & t_config,
+            const CellBuffer & t_cells,
+            const CellRect_t & t_visibleCells,
+            const sf::Vector2f & t_origin,
+            const float t_cellSize,
+            sf::RenderTarget & t_target,
+            const sf::RenderStates & t_states);
+
+        // the same as draw() but in blocks of t_level instead of cells, each between
+        // colorOff and colorOn by how many of its cells are alive
+        void drawDensity(
+            const Config & t_config,
+            const DensityLevel & t_level,
+            const CellRect_t & t_visibleBlocks,
+            const sf::Vector2f & t_origin,
+            const float t_blockSize,
+            sf::RenderTarget & t_target,
+            const sf::RenderStates & t_states);
+
+      private:
+        // draw() for video cards without shaders
+        void drawUnshaded(
+            const Config & t_config,
+            const CellRect_t & t_visibleCells,
+            const sf::Vector2f & t_origin,
+            const float t_cellSize,
+            sf::RenderTarget & t_target,
+            const sf::RenderStates & t_states);
+
+        // the texture only ever holds t_rect, so moving the view uploads all of it again
+        void upload(const CellBuffer & t_cells, const CellRect_t & t_rect);
+
+        // [t_beginY, t_endY) and [t_beginX, t_endX) of the texture, from the same cells
+        void uploadRect(
+            const CellBuffer & t_cells,
+            const std::size_t t_beginX,
+            const std::size_t t_endX,
+            const std::size_t t_beginY,
+            const std::size_t t_endY);
+
+      private:
+        bool m_isShaded;
+        sf::Shader m_shader;
+        sf::Texture m_texture;
+        sf::Texture m_densityTexture; // every draw uploads all of it, and it's drawn unshaded
+        sf::Vector2<std::size_t> m_texturePosition; // the cell that is texel (0,0)
+        std::vector<CellType_t> m_uploadedCells;    // what the texture holds
+        std::vector<std::uint8_t> m_pixels;         // RGBA, only as big as the last rect uploaded
+
+        static const std::string m_vertexShaderCode;
+        static const std::string m_fragmentShaderCode;
+    };
+
+} // namespace gameoflife
+
+#endif // CELL_SHADER_HPP_INCLUDED
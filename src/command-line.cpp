@@ -0,0 +1,280 @@
+//
+// command-line.cpp
+//
+#include "command-line.hpp"
+
+#include "rule.hpp"
+
+#include <charconv>
+#include <cstdlib>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+
+namespace gameoflife
+{
+
+    namespace
+    {
+        template <typename Number_t>
+        Number_t parseNumber(const std::string_view t_name, const std::string_view t_value)
+        {
+            Number_t number{};
+            bool isValid{ !t_value.empty() };
+
+            // not every standard library has std::from_chars() for floating point yet
+            if constexpr (std::is_floating_point_v<Number_t>)
+            {
+                const std::string text{ t_value };
+                char * end{ nullptr };
+                number  = static_cast<Number_t>(std::strtod(text.c_str(), &end));
+                isValid = (isValid && (end == (text.c_str() + text.size())));
+            }
+            else
+            {
+                const char * const end{ t_value.data() + t_value.size() };
+                const auto [pointer, error]{ std::from_chars(t_value.data(), end, number) };
+                isValid = (isValid && (error == std::errc{}) && (pointer == end));
+            }
+
+            if (!isValid)
+            {
+                throw std::runtime_error(
+                    "The command line option --" + std::string{ t_name } +
+                    " needs a number, not \"" + std::string{ t_value } + "\".");
+            }
+
+            return number;
+        }
+
+        // "WIDTHxHEIGHT"
+        sf::Vector2u parseSize(const std::string_view t_name, const std::string_view t_value)
+        {
+            const std::size_t separator{ t_value.find('x') };
+            if (separator == std::string_view::npos)
+            {
+                throw std::runtime_error(
+                    "The command line option --" + std::string{ t_name } +
+                    " needs a WIDTHxHEIGHT like 100x60, not \"" + std::string{ t_value } + "\".");
+            }
+
+            const sf::Vector2u size{ parseNumber<unsigned>(t_name, t_value.substr(0, separator)),
+                                     parseNumber<unsigned>(t_name, t_value.substr(separator + 1)) };
+
+            if ((size.x == 0) || (size.y == 0))
+            {
+                throw std::runtime_error("The board can't be empty.");
+            }
+
+            return size;
+        }
+
+        SimdLevel parseSimdLevel(const std::string_view t_value)
+        {
+            for (const SimdLevel level : { SimdLevel::Scalar, SimdLevel::Sse2, SimdLevel::Avx2 })
+            {
+                if (toString(level) == t_value)
+                {
+                    return level;
+                }
+            }
+
+            throw std::runtime_error(
+                "Unknown SIMD level \"" + std::string{ t_value } + "\", try scalar, sse2 or avx2.");
+        }
+
+        util::BloomQuality parseBloomQuality(const std::string_view t_value)
+        {
+            for (const util::BloomQuality quality :
+                 { util::BloomQuality::Off,
+                   util::BloomQuality::Low,
+                   util::BloomQuality::Medium,
+                   util::BloomQuality::High })
+            {
+                if (util::toString(quality) == t_value)
+                {
+                    return quality;
+                }
+            }
+
+            throw std::runtime_error(
+                "Unknown bloom quality \"" + std::string{ t_value } +
+                "\", try off, low, medium or high.");
+        }
+    } // namespace
+
+    CommandLine parseCommandLine(const int t_argc, const char * const t_argv[], Config & t_config)
+    {
+        CommandLine commandLine;
+
+        for (int index{ 1 }; index < t_argc; ++index)
+        {
+            const std::string_view argument{ t_argv[index] };
+            if (!argument.starts_with("--"))
+            {
+                throw std::runtime_error(
+                    "Unknown command line argument \"" + std::string{ argument } +
+                    "\", try --help.");
+            }
+
+            const std::size_t equals{ argument.find('=') };
+            const std::string_view name{ argument.substr(2, (equals - 2)) };
+            const std::string_view value{ (equals == std::string_view::npos)
+                                              ? std::string_view{}
+                                              : argument.substr(equals + 1) };
+
+            if (name == "help")
+            {
+                commandLine.is_help_requested = true;
+            }
+            else if (name == "headless")
+            {
+                commandLine.is_headless = true;
+            }
+            else if (name == "generations")
+            {
+                commandLine.generation_count = parseNumber<std::size_t>(name, value);
+            }
+            else if (name == "pattern")
+            {
+                commandLine.pattern_name = value;
+            }
+            else if (name == "file")
+            {
+                commandLine.pattern_path = value;
+            }
+            else if (name == "random")
+            {
+                commandLine.random_density = parseNumber<float>(name, value);
+                if ((commandLine.random_density < 0.0f) || (commandLine.random_density > 1.0f))
+                {
+                    throw std::runtime_error("The --random density must be from 0 to 1.");
+                }
+            }
+            else if (name == "seed")
+            {
+                commandLine.random_seed = parseNumber<unsigned>(name, value);
+            }
+            else if (name == "size")
+            {
+                t_config.cell_counts = parseSize(name, value);
+            }
+            else if (name == "rule")
+            {
+                // only to fail here instead of after the window is open
+                t_config.rule = toString(parseRule(value));
+            }
+            else if (name == "torus")
+            {
+                t_config.is_toroidal = true;
+            }
+            else if (name == "engine")
+            {
+                t_config.engine = parseEngineType(value);
+            }
+            else if (name == "threads")
+            {
+                t_config.thread_count = parseNumber<std::size_t>(name, value);
+            }
+            else if (name == "simd")
+            {
+                t_config.max_simd_level = parseSimdLevel(value);
+            }
+            else if (name == "frame-budget")
+            {
+                t_config.frame_budget_ms = parseNumber<float>(name, value);
+                if (!(t_config.frame_budget_ms > 0.0f))
+                {
+                    throw std::runtime_error("The --frame-budget must be more than zero.");
+                }
+            }
+            else if (name == "bloom")
+            {
+                t_config.bloom_quality = parseBloomQuality(value);
+            }
+            else if (name == "export")
+            {
+                commandLine.export_directory = value;
+                if (commandLine.export_directory.empty())
+                {
+                    throw std::runtime_error("The --export option needs a directory.");
+                }
+            }
+            else if (name == "export-every")
+            {
+                commandLine.export_interval = parseNumber<std::size_t>(name, value);
+                if (0 == commandLine.export_interval)
+                {
+                    throw std::runtime_error("The --export-every must be more than zero.");
+                }
+            }
+            else if (name == "export-format")
+            {
+                commandLine.export_format = parseFrameFormat(value);
+            }
+            else if (name == "export-render")
+            {
+                commandLine.is_export_rendered = true;
+            }
+            else if (name == "export-threads")
+            {
+                commandLine.export_thread_count = parseNumber<std::size_t>(name, value);
+            }
+            else if (name == "export-queue")
+            {
+                commandLine.export_queue_size = parseNumber<std::size_t>(name, value);
+                if (0 == commandLine.export_queue_size)
+                {
+                    throw std::runtime_error("The --export-queue must be more than zero.");
+                }
+            }
+            else
+            {
+                throw std::runtime_error(
+                    "Unknown command line option \"" + std::string{ argument } +
+                    "\", try --help.");
+            }
+        }
+
+        if (!commandLine.export_directory.empty() && !commandLine.is_headless)
+        {
+            throw std::runtime_error("The --export option only works with --headless.");
+        }
+
+        return commandLine;
+    }
+
+    std::string commandLineHelp()
+    {
+        return "Options:\n"
+               "  --help                 this\n"
+               "  --headless             no window, just run --generations as fast as possible\n"
+               "  --generations=N        how many the headless mode runs (1000)\n"
+               "  --pattern=NAME         headless starts with a preset, one of: glider,\n"
+               "                         r-pentomino, diehard, acorn, infinite-block-1,\n"
+               "                         infinite-block-2, penta-decathlon, broken-line,\n"
+               "                         gosper-glider-gun\n"
+               "  --file=PATH            headless starts with a .rle or plaintext .cells file\n"
+               "  --random=DENSITY       headless starts with each cell alive by this chance\n"
+               "  --seed=N               for --random, the same seed gives the same board\n"
+               "  --size=WIDTHxHEIGHT    cells on the board (100x60)\n"
+               "  --rule=B3/S23          any Life-like rule in B/S notation\n"
+               "  --torus                the edges of the board wrap around\n"
+               "  --engine=NAME          one of: " +
+               engineTypeNames() +
+               "\n"
+               "  --threads=N            zero means one per hardware thread (0)\n"
+               "  --simd=LEVEL           the most the reference engine uses: scalar, sse2, avx2\n"
+               "  --frame-budget=MS      the most time spent stepping before showing the board,\n"
+               "                         which is all of it in max speed mode (M key) (15)\n"
+               "  --bloom=QUALITY        off, low, medium (wider than low) or high (high)\n"
+               "  --export=DIR           headless also writes generations to DIR as it goes\n"
+               "  --export-every=N       only every Nth generation, starting with the first (1)\n"
+               "  --export-format=NAME   png for a file each or y4m for one video (png)\n"
+               "  --export-render        draw them like the window does, bloom and all, at the\n"
+               "                         window's size instead of one pixel per cell\n"
+               "  --export-threads=N     encoding threads, zero means one per hardware thread (0)\n"
+               "  --export-queue=N       frames waiting to be encoded before the board waits (8)\n";
+    }
+
+} // namespace gameoflife
@@ -0,0 +1,43 @@
+#ifndef COMMAND_LINE_HPP_INCLUDED
+#define COMMAND_LINE_HPP_INCLUDED
+//
+// command-line.hpp
+//
+#include "config.hpp"
+#include "frame-exporter.hpp"
+
+#include <cstddef>
+#include <string>
+
+namespace gameoflife
+{
+
+    // everything on the command line that isn't already part of Config
+    struct CommandLine
+    {
+        bool is_help_requested{ false };
+        bool is_headless{ false }; // see headless.hpp
+        std::size_t generation_count{ 1000 };
+        std::string pattern_name; // one of the presets in patterns.cpp
+        std::string pattern_path; // a .rle or plaintext .cells file
+        float random_density{ 0.0f };
+        unsigned random_seed{ 0 };
+
+        // headless only, see frame-exporter.hpp
+        std::string export_directory;     // nothing is exported if empty
+        std::size_t export_interval{ 1 }; // in generations
+        FrameFormat export_format{ FrameFormat::Png };
+        bool is_export_rendered{ false };     // like the window instead of one pixel per cell
+        std::size_t export_thread_count{ 0 }; // zero means one per hardware thread
+        std::size_t export_queue_size{ 8 };   // in frames
+    };
+
+    // Options are "--name=value" or just "--name".  Any that set part of Config are written
+    // into t_config.  Throws std::runtime_error for anything it doesn't understand.
+    CommandLine parseCommandLine(const int t_argc, const char * const t_argv[], Config & t_config);
+
+    std::string commandLineHelp();
+
+} // namespace gameoflife
+
+#endif // COMMAND_LINE_HPP_INCLUDED
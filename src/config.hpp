@@ -3,10 +3,16 @@
 //
 // config.hpp
 //
+#include "bloom-quality.hpp"
+#include "byte-kernel.hpp"
+#include "engine.hpp"
+
 #include <SFML/Graphics/Color.hpp>
 #include <SFML/System/Vector2.hpp>
 #include <SFML/Window/VideoMode.hpp>
 
+#include <string>
+
 namespace gameoflife
 {
 
@@ -20,6 +26,14 @@ namespace gameoflife
         sf::Color grid_color_off{ 22, 22, 22 };
         sf::Color grid_color_outline{ 0, 0, 0 };
         sf::Color grid_color_on{ 250, 230, 110 };
+        std::string rule{ "B3/S23" }; // B/S notation, so "B36/S23" is HighLife, see rule.hpp
+        bool is_toroidal{ false };    // cells past one edge are the cells at the opposite edge
+        EngineType engine{ EngineType::BitPacked };
+        std::size_t thread_count{ 0 }; // zero means one per hardware thread
+        SimdLevel max_simd_level{ SimdLevel::Avx2 }; // the CPU might support less
+        std::size_t hashlife_memory_limit_mb{ 1024 };
+        float frame_budget_ms{ 15.0f }; // the most stepping between showing generations
+        util::BloomQuality bloom_quality{ util::BloomQuality::High };
     };
 
 } // namespace gameoflife
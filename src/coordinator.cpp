@@ -3,28 +3,61 @@
 //
 #include "coordinator.hpp"
 
+#include "cpu-bloom.hpp"
+#include "patterns.hpp"
 #include "sfml-util.hpp"
 
-#include <SFML/System/Clock.hpp>
-
+#include <algorithm>
 #include <iostream>
+#include <limits>
+#include <utility>
 
 namespace gameoflife
 {
 
+    namespace
+    {
+        constexpr std::size_t fast_forward_step_count{ 1024 };
+
+        // how often max speed mode shows the generations/sec it is getting
+        constexpr std::chrono::seconds speed_report_period{ 1 };
+
+        // how far one turn of the mouse wheel zooms, and one key press pans
+        constexpr float zoom_step_factor{ 1.25f };
+        constexpr float pan_screen_ratio{ 0.1f };
+
+        // how long an idle loop waits for an event before checking for a new generation again
+        const sf::Time idle_wait_time{ sf::milliseconds(10) };
+    } // namespace
+
     Coordinator::Coordinator()
         : m_config{}
         , m_renderStates{}
         , m_renderWindow{}
         , m_bloomWindowPtr{}
         , m_grid{}
+        , m_generations{}
         , m_isRunning{ true }
-        , m_elapsedTimeSec{ 0.0f }
+        , m_isRedrawNeeded{ true }
+        , m_speedOverlayPtr{}
+        , m_generationsPerSec{ 0 }
+        , m_simThread{}
+        , m_commandMutex{}
+        , m_commandCondition{}
+        , m_commands{}
+        , m_simExceptionPtr{}
+        , m_lastStepTime{}
         , m_stepDelaySec{ 0.25f }
         , m_isPaused{ true }
+        , m_isMaxSpeed{ false }
         , m_stepCounter{ 0 }
+        , m_speedStartTime{}
+        , m_speedStepCount{ 0 }
+        , m_changedRows{}
     {}
 
+    Coordinator::~Coordinator() { stopSimulation(); }
+
     void Coordinator::run(const Config & t_config)
     {
         setup(t_config);
@@ -36,24 +69,63 @@ namespace gameoflife
     {
         m_config = t_config;
         setupRenderWindow(m_config.video_mode);
-        m_bloomWindowPtr = std::make_unique<util::BloomEffectHelper>(m_renderWindow);
-        m_bloomWindowPtr->isEnabled(true);
+
+        // without shaders the bloom is done on the CPU instead
+        std::unique_ptr<util::IFrameBloom> fallbackPtr;
+        if (!util::BloomEffect::isSupported())
+        {
+            fallbackPtr = std::make_unique<CpuBloom>(m_config.thread_count);
+        }
+
+        m_bloomWindowPtr =
+            std::make_unique<util::BloomEffectHelper>(m_renderWindow, std::move(fallbackPtr));
+
+        m_bloomWindowPtr->quality(m_config.bloom_quality);
         m_bloomWindowPtr->blurMultipassCount(3);
         m_grid.setup(m_config);
+        m_speedOverlayPtr = std::make_unique<SpeedOverlay>(m_config);
+        m_simThread = std::thread(&Coordinator::simulate, this);
     }
 
     void Coordinator::loop()
     {
-        sf::Clock frameClock;
         while (m_bloomWindowPtr->isOpen() && m_isRunning)
         {
             handleEvents();
-            update(frameClock.restart().asSeconds());
-            draw();
+
+            // never waits, and returns false if nothing new was published since the last frame
+            if (m_generations.update() ||
+                (m_generationsPerSec != m_speedOverlayPtr->generationsPerSec()))
+            {
+                m_isRedrawNeeded = true;
+            }
+
+            // Redrawing and running the bloom on an unchanged board only heats up the GPU, and
+            // the window keeps showing the last frame anyway.  The simulation thread can't wake
+            // waitEvent(), so the wait is short enough that a new generation is still seen soon.
+            if (m_isRedrawNeeded)
+            {
+                draw();
+                m_isRedrawNeeded = false;
+            }
+            else if (const auto eventOpt = m_renderWindow.waitEvent(idle_wait_time))
+            {
+                handleEvent(eventOpt.value());
+            }
         }
     }
 
-    void Coordinator::teardown() { std::cout << "Step Count=" << m_stepCounter << '\n'; }
+    void Coordinator::teardown()
+    {
+        stopSimulation();
+
+        if (m_simExceptionPtr)
+        {
+            std::rethrow_exception(m_simExceptionPtr);
+        }
+
+        std::cout << "Step Count=" << m_stepCounter << '\n';
+    }
 
     void Coordinator::setupRenderWindow(sf::VideoMode & t_videoMode)
     {
@@ -112,208 +184,384 @@ namespace gameoflife
             m_isRunning = false;
             std::cout << "Stopping because window was closed externally.\n";
         }
+        else if (t_event.is<sf::Event::Resized>() || t_event.is<sf::Event::FocusGained>())
+        {
+            // what the window showed might have been lost
+            m_isRedrawNeeded = true;
+        }
         else if (const auto * keyPtr = t_event.getIf<sf::Event::KeyPressed>())
         {
+            const sf::Vector2f panStep{ pan_screen_ratio *
+                                        sf::Vector2f{ m_config.video_mode.size } };
+
             if (keyPtr->scancode == sf::Keyboard::Scancode::Escape)
             {
                 m_isRunning = false;
             }
             else if (keyPtr->scancode == sf::Keyboard::Scancode::Up)
             {
-                m_stepDelaySec *= 0.9f;
+                post([this]() { m_stepDelaySec *= 0.9f; });
             }
             else if (keyPtr->scancode == sf::Keyboard::Scancode::Down)
             {
-                m_stepDelaySec *= 1.1f;
+                post([this]() { m_stepDelaySec *= 1.1f; });
             }
             else if (keyPtr->scancode == sf::Keyboard::Scancode::Space)
             {
-                m_isPaused = !m_isPaused;
+                post([this]() {
+                    m_isPaused     = !m_isPaused;
+                    m_lastStepTime = std::chrono::steady_clock::now();
+                });
             }
             else if (keyPtr->scancode == sf::Keyboard::Scancode::Right)
             {
-                m_grid.processStep();
-                ++m_stepCounter;
+                post([this]() {
+                    m_grid.processStep();
+                    ++m_stepCounter;
+                });
             }
-            else if (keyPtr->scancode == sf::Keyboard::Scancode::R)
+            else if (keyPtr->scancode == sf::Keyboard::Scancode::M)
             {
-                reset();
+                post([this]() {
+                    m_isMaxSpeed = !m_isMaxSpeed;
+
+                    // switching it off leaves a paused board paused
+                    if (m_isMaxSpeed)
+                    {
+                        m_isPaused = false;
+                    }
+
+                    m_lastStepTime   = std::chrono::steady_clock::now();
+                    m_speedStartTime = m_lastStepTime;
+                    m_speedStepCount = 0;
+
+                    // hidden until the first report
+                    m_generationsPerSec = 0;
+                });
             }
-            else if (keyPtr->scancode == sf::Keyboard::Scancode::Num1)
+            else if (keyPtr->scancode == sf::Keyboard::Scancode::F)
             {
-                // Glider
-                reset();
-                const sf::Vector2i centerPosition{ m_config.cell_counts / 2u };
-                m_grid.setCellValue(centerPosition + sf::Vector2i{ 3, 0 }, 1);
-                m_grid.setCellValue(centerPosition + sf::Vector2i{ 3, 1 }, 1);
-                m_grid.setCellValue(centerPosition + sf::Vector2i{ 3, 2 }, 1);
-                m_grid.setCellValue(centerPosition + sf::Vector2i{ 2, 2 }, 1);
-                m_grid.setCellValue(centerPosition + sf::Vector2i{ 1, 1 }, 1);
+                // only actually fast with the HashLife engine
+                post([this]() {
+                    m_grid.processSteps(fast_forward_step_count);
+                    m_stepCounter += fast_forward_step_count;
+                });
             }
-            else if (keyPtr->scancode == sf::Keyboard::Scancode::Num2)
+            else if (keyPtr->scancode == sf::Keyboard::Scancode::R)
             {
-                // The R-pentomino
-                reset();
-                const sf::Vector2i centerPosition{ m_config.cell_counts / 2u };
-                m_grid.setCellValue(centerPosition + sf::Vector2i{ 0, 0 }, 1);
-                m_grid.setCellValue(centerPosition + sf::Vector2i{ 0, 1 }, 1);
-                m_grid.setCellValue(centerPosition + sf::Vector2i{ 0, 2 }, 1);
-                m_grid.setCellValue(centerPosition + sf::Vector2i{ 1, 0 }, 1);
-                m_grid.setCellValue(centerPosition + sf::Vector2i{ -1, 1 }, 1);
+                post([this]() { reset(); });
             }
-            else if (keyPtr->scancode == sf::Keyboard::Scancode::Num3)
+            else if (keyPtr->scancode == sf::Keyboard::Scancode::Home)
             {
-                // Diehard
-                reset();
-                const sf::Vector2i centerPosition{ m_config.cell_counts / 2u };
-                m_grid.setCellValue(centerPosition + sf::Vector2i{ -5, 0 }, 1);
-                m_grid.setCellValue(centerPosition + sf::Vector2i{ -4, 0 }, 1);
-                m_grid.setCellValue(centerPosition + sf::Vector2i{ -4, 1 }, 1);
-
-                m_grid.setCellValue(centerPosition + sf::Vector2i{ 0, 1 }, 1);
-                m_grid.setCellValue(centerPosition + sf::Vector2i{ 1, 1 }, 1);
-                m_grid.setCellValue(centerPosition + sf::Vector2i{ 2, 1 }, 1);
-                m_grid.setCellValue(centerPosition + sf::Vector2i{ 1, -1 }, 1);
+                m_grid.fitView();
+                m_isRedrawNeeded = true;
             }
-            else if (keyPtr->scancode == sf::Keyboard::Scancode::Num4)
+            else if (keyPtr->scancode == sf::Keyboard::Scancode::W)
             {
-                // Acorn
-                reset();
-                const sf::Vector2i centerPosition{ m_config.cell_counts / 2u };
-                m_grid.setCellValue(centerPosition + sf::Vector2i{ -3, 0 }, 1);
-                m_grid.setCellValue(centerPosition + sf::Vector2i{ -2, 0 }, 1);
-                m_grid.setCellValue(centerPosition + sf::Vector2i{ -2, -2 }, 1);
-
-                m_grid.setCellValue(centerPosition + sf::Vector2i{ 0, -1 }, 1);
-                m_grid.setCellValue(centerPosition + sf::Vector2i{ 1, 0 }, 1);
-                m_grid.setCellValue(centerPosition + sf::Vector2i{ 2, 0 }, 1);
-                m_grid.setCellValue(centerPosition + sf::Vector2i{ 3, 0 }, 1);
+                m_grid.panView({ 0.0f, panStep.y });
+                m_isRedrawNeeded = true;
             }
-            else if (keyPtr->scancode == sf::Keyboard::Scancode::Num5)
+            else if (keyPtr->scancode == sf::Keyboard::Scancode::S)
             {
-                // Infinite Block 1
-                reset();
-                const sf::Vector2i centerPosition{ m_config.cell_counts / 2u };
-                m_grid.setCellValue(centerPosition + sf::Vector2i{ -4, 0 }, 1);
-
-                m_grid.setCellValue(centerPosition + sf::Vector2i{ -2, 0 }, 1);
-                m_grid.setCellValue(centerPosition + sf::Vector2i{ -2, -1 }, 1);
-
-                m_grid.setCellValue(centerPosition + sf::Vector2i{ 0, -2 }, 1);
-                m_grid.setCellValue(centerPosition + sf::Vector2i{ 0, -3 }, 1);
-                m_grid.setCellValue(centerPosition + sf::Vector2i{ 0, -4 }, 1);
-
-                m_grid.setCellValue(centerPosition + sf::Vector2i{ 2, -3 }, 1);
-                m_grid.setCellValue(centerPosition + sf::Vector2i{ 2, -4 }, 1);
-                m_grid.setCellValue(centerPosition + sf::Vector2i{ 2, -5 }, 1);
-
-                m_grid.setCellValue(centerPosition + sf::Vector2i{ 3, -4 }, 1);
+                m_grid.panView({ 0.0f, -panStep.y });
+                m_isRedrawNeeded = true;
+            }
+            else if (keyPtr->scancode == sf::Keyboard::Scancode::A)
+            {
+                m_grid.panView({ panStep.x, 0.0f });
+                m_isRedrawNeeded = true;
             }
-            else if (keyPtr->scancode == sf::Keyboard::Scancode::Num6)
+            else if (keyPtr->scancode == sf::Keyboard::Scancode::D)
             {
-                // Infinite Block 2
-                reset();
-                const sf::Vector2i centerPosition{ m_config.cell_counts / 2u };
-                m_grid.setCellValue(centerPosition + sf::Vector2i{ -3, 0 }, 1);
-                m_grid.setCellValue(centerPosition + sf::Vector2i{ -2, 0 }, 1);
-                m_grid.setCellValue(centerPosition + sf::Vector2i{ -1, 0 }, 1);
-                m_grid.setCellValue(centerPosition + sf::Vector2i{ 1, 0 }, 1);
-
-                m_grid.setCellValue(centerPosition + sf::Vector2i{ -3, 1 }, 1);
-
-                m_grid.setCellValue(centerPosition + sf::Vector2i{ 0, 2 }, 1);
-                m_grid.setCellValue(centerPosition + sf::Vector2i{ 1, 2 }, 1);
-
-                m_grid.setCellValue(centerPosition + sf::Vector2i{ -2, 3 }, 1);
-                m_grid.setCellValue(centerPosition + sf::Vector2i{ -1, 3 }, 1);
-                m_grid.setCellValue(centerPosition + sf::Vector2i{ 1, 3 }, 1);
-
-                m_grid.setCellValue(centerPosition + sf::Vector2i{ -3, 4 }, 1);
-                m_grid.setCellValue(centerPosition + sf::Vector2i{ -1, 4 }, 1);
-                m_grid.setCellValue(centerPosition + sf::Vector2i{ 1, 4 }, 1);
+                m_grid.panView({ -panStep.x, 0.0f });
+                m_isRedrawNeeded = true;
             }
-            else if (keyPtr->scancode == sf::Keyboard::Scancode::Num7)
+            else if (
+                (keyPtr->scancode >= sf::Keyboard::Scancode::Num1) &&
+                (keyPtr->scancode <= sf::Keyboard::Scancode::Num9))
             {
-                // Penta-decathlon
-                reset();
-                const sf::Vector2i centerPosition{ m_config.cell_counts / 2u };
-                for (int y{ -1 }; y < 2; ++y)
+                // the presets are in the same order as the keys, see patterns.cpp
+                const std::size_t presetIndex{ static_cast<std::size_t>(
+                    static_cast<int>(keyPtr->scancode) -
+                    static_cast<int>(sf::Keyboard::Scancode::Num1)) };
+
+                post([this, presetIndex]() {
+                    reset();
+                    placePattern(
+                        m_grid,
+                        presetPatterns().at(presetIndex),
+                        sf::Vector2i{ m_config.cell_counts / 2u });
+                });
+            }
+        }
+        else if (const auto * wheelPtr = t_event.getIf<sf::Event::MouseWheelScrolled>())
+        {
+            const float factor{ (wheelPtr->delta > 0.0f) ? zoom_step_factor
+                                                         : (1.0f / zoom_step_factor) };
+
+            m_grid.zoomView(factor, sf::Vector2f{ wheelPtr->position });
+            m_isRedrawNeeded = true;
+        }
+        else if (const auto * mousePtr = t_event.getIf<sf::Event::MouseButtonPressed>())
+        {
+            // the view belongs to this thread, so find the cell here and not in the command
+            const GridPos_t gridPos{ m_grid.screenPositionToGridPosition(
+                sf::Vector2f{ mousePtr->position }) };
+
+            post([this, gridPos]() {
+                if (!m_isPaused)
                 {
-                    for (int x{ -4 }; x < 4; ++x)
-                    {
-                        m_grid.setCellValue(centerPosition + sf::Vector2i{ x, y }, 1);
-                    }
+                    return;
                 }
 
-                m_grid.setCellValue(centerPosition + sf::Vector2i{ -3, 0 }, 0);
-                m_grid.setCellValue(centerPosition + sf::Vector2i{ 2, 0 }, 0);
-            }
-            else if (keyPtr->scancode == sf::Keyboard::Scancode::Num8)
-            {
-                // ?
-                reset();
-                const sf::Vector2i centerPosition{ m_config.cell_counts / 2u };
-                for (int x{ -19 }; x <= 19; ++x)
+                if (m_grid.getCellValue(gridPos) == 0)
                 {
-                    m_grid.setCellValue(centerPosition + sf::Vector2i{ x, 0 }, 1);
+                    m_grid.setCellValue(gridPos, 1);
                 }
+                else
+                {
+                    m_grid.setCellValue(gridPos, 0);
+                }
+            });
+        }
+    }
+
+    void Coordinator::draw()
+    {
+        // Grid::draw() only reads what Grid::setup() made and the view, which the simulation
+        // thread never touches, so it's safe to call while the simulation thread steps
+        m_bloomWindowPtr->clear(sf::Color::Black);
 
-                m_grid.setCellValue(centerPosition + sf::Vector2i{ -11, 0 }, 0);
+        const Generation & generation{ m_generations.front() };
 
-                m_grid.setCellValue(centerPosition + sf::Vector2i{ -5, 0 }, 0);
-                m_grid.setCellValue(centerPosition + sf::Vector2i{ -4, 0 }, 0);
-                m_grid.setCellValue(centerPosition + sf::Vector2i{ -3, 0 }, 0);
+        m_grid.draw(
+            m_config,
+            generation.cells,
+            generation.density,
+            m_bloomWindowPtr->renderTarget(),
+            m_renderStates);
 
-                m_grid.setCellValue(centerPosition + sf::Vector2i{ 1, 0 }, 0);
-                m_grid.setCellValue(centerPosition + sf::Vector2i{ 2, 0 }, 0);
-                m_grid.setCellValue(centerPosition + sf::Vector2i{ 3, 0 }, 0);
-                m_grid.setCellValue(centerPosition + sf::Vector2i{ 4, 0 }, 0);
-                m_grid.setCellValue(centerPosition + sf::Vector2i{ 5, 0 }, 0);
-                m_grid.setCellValue(centerPosition + sf::Vector2i{ 6, 0 }, 0);
+        m_speedOverlayPtr->generationsPerSec(m_generationsPerSec);
+        m_bloomWindowPtr->display(*m_speedOverlayPtr);
+    }
 
-                m_grid.setCellValue(centerPosition + sf::Vector2i{ 14, 0 }, 0);
-            }
+    void Coordinator::post(Command_t t_command)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_commandMutex);
+            m_commands.push_back(std::move(t_command));
         }
-        else if (const auto * mousePtr = t_event.getIf<sf::Event::MouseButtonPressed>())
+
+        m_commandCondition.notify_one();
+    }
+
+    void Coordinator::stopSimulation()
+    {
+        // under the lock so the simulation thread can't miss it between checking and waiting
+        {
+            std::lock_guard<std::mutex> lock(m_commandMutex);
+            m_isRunning = false;
+        }
+
+        m_commandCondition.notify_one();
+
+        if (m_simThread.joinable())
+        {
+            m_simThread.join();
+        }
+    }
+
+    void Coordinator::simulate()
+    {
+        try
         {
-            if (m_isPaused)
+            publishGeneration();
+
+            std::vector<Command_t> commands;
+            while (m_isRunning)
             {
-                const GridPos_t gridPos{ m_grid.screenPositionToGridPosition(
-                    sf::Vector2f{ mousePtr->position }) };
+                // sleeps until there is a command, or until the next step is due
+                {
+                    std::unique_lock<std::mutex> lock(m_commandMutex);
 
-                if (m_grid.getCellValue(gridPos) == 0)
+                    const auto isWoken{ [this]() { return (!m_isRunning || !m_commands.empty()); } };
+
+                    if (m_isPaused)
+                    {
+                        m_commandCondition.wait(lock, isWoken);
+                    }
+                    else if (!m_isMaxSpeed)
+                    {
+                        m_commandCondition.wait_until(lock, (m_lastStepTime + stepDelay()), isWoken);
+                    }
+
+                    commands.swap(m_commands);
+                }
+
+                bool isChanged{ !commands.empty() };
+                for (const Command_t & command : commands)
                 {
-                    m_grid.setCellValue(gridPos, 1);
+                    command();
                 }
-                else
+
+                commands.clear();
+
+                if (!m_isPaused && stepWhenDue())
                 {
-                    m_grid.setCellValue(gridPos, 0);
+                    isChanged = true;
+                }
+
+                if (isChanged)
+                {
+                    publishGeneration();
                 }
             }
         }
+        catch (...)
+        {
+            // rethrown on the main thread by teardown()
+            m_simExceptionPtr = std::current_exception();
+            m_isRunning       = false;
+        }
     }
 
-    void Coordinator::update(const float t_elapsedTimeSec)
+    std::chrono::steady_clock::duration Coordinator::stepDelay() const
     {
-        if (m_isPaused)
+        // never zero, no matter how many times the Up key shrinks it
+        return std::max(
+            std::chrono::steady_clock::duration{ 1 },
+            std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::duration<float>{ m_stepDelaySec }));
+    }
+
+    bool Coordinator::stepWhenDue()
+    {
+        if (m_isMaxSpeed)
         {
-            return;
+            const std::size_t stepCount{ stepWithinBudget(
+                std::numeric_limits<std::size_t>::max()) };
+
+            m_lastStepTime = std::chrono::steady_clock::now();
+            m_speedStepCount += stepCount;
+            reportSpeed();
+            return true;
+        }
+
+        // a fixed timestep, so steps that came due while the last ones ran aren't lost
+        const auto delay{ stepDelay() };
+        const auto dueCount{ static_cast<std::size_t>(
+            (std::chrono::steady_clock::now() - m_lastStepTime) / delay) };
+
+        if (0 == dueCount)
+        {
+            return false;
+        }
+
+        const std::size_t stepCount{ stepWithinBudget(dueCount) };
+        if (stepCount < dueCount)
+        {
+            // can't keep up, so drop the rest instead of falling further and further behind
+            m_lastStepTime = std::chrono::steady_clock::now();
         }
+        else
+        {
+            m_lastStepTime += (delay * static_cast<std::chrono::steady_clock::rep>(stepCount));
+        }
+
+        return true;
+    }
+
+    std::size_t Coordinator::stepWithinBudget(const std::size_t t_maxCount)
+    {
+        const std::chrono::duration<double, std::milli> budget{ m_config.frame_budget_ms };
+        const auto startTime{ std::chrono::steady_clock::now() };
 
-        m_elapsedTimeSec += t_elapsedTimeSec;
-        if (m_elapsedTimeSec > m_stepDelaySec)
+        // in batches, since some engines (HashLife) do many steps much faster than one at a time
+        std::size_t stepCount{ 0 };
+        std::size_t batchSize{ 1 };
+        while (stepCount < t_maxCount)
         {
-            m_elapsedTimeSec = 0.0f;
-            m_grid.processStep();
-            ++m_stepCounter;
+            const std::size_t batchCount{ std::min(batchSize, (t_maxCount - stepCount)) };
+            m_grid.processSteps(batchCount);
+            stepCount += batchCount;
+
+            const std::chrono::duration<double, std::milli> elapsed{
+                std::chrono::steady_clock::now() - startTime
+            };
+
+            if (elapsed >= budget)
+            {
+                break;
+            }
+
+            // aim at what's left of the budget by how fast it has gone so far, but never grow
+            // faster than doubling in case the steps so far were unusually quick
+            const double aimedCount{ static_cast<double>(stepCount) *
+                                     ((budget - elapsed) / std::max(elapsed, budget / 1000.0)) };
+
+            batchSize = std::clamp(
+                static_cast<std::size_t>(aimedCount), std::size_t{ 1 }, (stepCount * 2));
         }
+
+        m_stepCounter += stepCount;
+        return stepCount;
     }
 
-    void Coordinator::draw()
+    void Coordinator::reportSpeed()
     {
-        m_bloomWindowPtr->clear(sf::Color::Black);
-        m_grid.draw(m_config, m_bloomWindowPtr->renderTarget(), m_renderStates);
-        m_bloomWindowPtr->display();
+        const std::chrono::duration<double> elapsed{ std::chrono::steady_clock::now() -
+                                                     m_speedStartTime };
+
+        if (elapsed < speed_report_period)
+        {
+            return;
+        }
+
+        m_generationsPerSec = static_cast<std::size_t>(
+            static_cast<double>(m_speedStepCount) / elapsed.count());
+
+        std::cout << "Max speed " << m_grid.engineName() << " engine: " << m_generationsPerSec
+                  << " generations/sec" << std::endl;
+
+        m_speedStartTime = std::chrono::steady_clock::now();
+        m_speedStepCount = 0;
+    }
+
+    void Coordinator::publishGeneration()
+    {
+        // The density is built here instead of in draw() so a frame never waits on it.  This
+        // slot still holds the cells it was last published with, so comparing each row with
+        // those finds the rows that changed since then.  Only those are copied, and only the
+        // density over them is rebuilt, which costs a lot less than summing every block again.
+        Generation & generation{ m_generations.back() };
+        const CellBuffer & cells{ m_grid.cells() };
+        m_changedRows.resize(cells.height());
+
+        if ((generation.cells.width() != cells.width()) ||
+            (generation.cells.height() != cells.height()))
+        {
+            generation.cells = cells;
+            std::fill(std::begin(m_changedRows), std::end(m_changedRows), std::uint8_t{ 1 });
+        }
+        else
+        {
+            for (std::size_t y{ 0 }; y < cells.height(); ++y)
+            {
+                const CellType_t * const row{ cells.row(y) };
+                const bool isChanged{ !std::equal(
+                    row, (row + cells.width()), generation.cells.row(y)) };
+
+                if (isChanged)
+                {
+                    std::copy(row, (row + cells.width()), generation.cells.row(y));
+                }
+
+                m_changedRows[y] = (isChanged ? 1 : 0);
+            }
+        }
+
+        generation.density.update(generation.cells, m_changedRows);
+        m_generations.publish();
     }
 
     void Coordinator::reset()
@@ -6,20 +6,46 @@
 #include "bloom-shader.hpp"
 #include "config.hpp"
 #include "grid.hpp"
+#include "speed-overlay.hpp"
+#include "triple-buffer.hpp"
 
 #include <SFML/Graphics/RenderWindow.hpp>
+#include <SFML/System/Time.hpp>
 #include <SFML/Window/Event.hpp>
 #include <SFML/Window/VideoMode.hpp>
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 namespace gameoflife
 {
 
+    // The window's events and drawing happen on the calling thread, while the Grid is stepped
+    // on a simulation thread of its own.  So a slow step never stalls input or drawing, and a
+    // slow frame never holds back the simulation.  Each finished generation is published
+    // through a TripleBuffer that draw() reads without waiting, and everything that changes
+    // the Grid is posted to the simulation thread as a command.
     class Coordinator
     {
       public:
         Coordinator();
+        ~Coordinator();
+
+        // prevent all copy and assignment
+        Coordinator(const Coordinator &) = delete;
+        Coordinator(Coordinator &&)      = delete;
+        //
+        Coordinator & operator=(const Coordinator &) = delete;
+        Coordinator & operator=(Coordinator &&)      = delete;
+
         void run(const Config & t_config);
 
       private:
@@ -31,8 +57,28 @@ namespace gameoflife
 
         void handleEvents();
         void handleEvent(const sf::Event & t_event);
-        void update(const float t_elapsedTimeSec);
         void draw();
+
+        // what the simulation thread publishes for draw()
+        struct Generation
+        {
+            CellBuffer cells;
+            DensityPyramid density; // of cells
+        };
+
+        using Command_t = std::function<void()>;
+
+        // runs t_command on the simulation thread before its next step
+        void post(Command_t t_command);
+        void stopSimulation();
+
+        // the rest only run on the simulation thread
+        void simulate();
+        std::chrono::steady_clock::duration stepDelay() const;
+        bool stepWhenDue();
+        std::size_t stepWithinBudget(const std::size_t t_maxCount);
+        void reportSpeed();
+        void publishGeneration();
         void reset();
 
       private:
@@ -40,12 +86,27 @@ namespace gameoflife
         sf::RenderStates m_renderStates;
         sf::RenderWindow m_renderWindow;
         std::unique_ptr<util::BloomEffectHelper> m_bloomWindowPtr;
-        Grid m_grid;
-        bool m_isRunning;
-        float m_elapsedTimeSec;
+        Grid m_grid; // only the simulation thread touches the cells once it starts
+        TripleBuffer<Generation> m_generations;
+        std::atomic<bool> m_isRunning;
+        bool m_isRedrawNeeded; // main thread only, set by a new generation or a view change
+        std::unique_ptr<SpeedOverlay> m_speedOverlayPtr; // main thread only
+        std::atomic<std::size_t> m_generationsPerSec;    // of max speed mode, zero otherwise
+        std::thread m_simThread;
+        std::mutex m_commandMutex;
+        std::condition_variable m_commandCondition;
+        std::vector<Command_t> m_commands;
+        std::exception_ptr m_simExceptionPtr;
+
+        // only used by the simulation thread
+        std::chrono::steady_clock::time_point m_lastStepTime;
         float m_stepDelaySec;
         bool m_isPaused;
+        bool m_isMaxSpeed; // ignores m_stepDelaySec and steps for all of each frame budget
         std::size_t m_stepCounter;
+        std::chrono::steady_clock::time_point m_speedStartTime;
+        std::size_t m_speedStepCount;
+        std::vector<std::uint8_t> m_changedRows; // by the last publishGeneration()
     };
 
 } // namespace gameoflife
@@ -0,0 +1,443 @@
+//
+// cpu-bloom.cpp
+//
+#include "cpu-bloom.hpp"
+
+#include "byte-kernel.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define GAMEOFLIFE_X86
+#endif
+
+// gcc and clang only emit AVX2 instructions inside functions marked like this, msvc always can
+#if defined(GAMEOFLIFE_X86) && defined(__GNUC__)
+#define GAMEOFLIFE_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define GAMEOFLIFE_TARGET_AVX2
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace gameoflife
+{
+
+    namespace
+    {
+        // any fewer and waking up the other threads costs more than it saves
+        constexpr std::size_t min_rows_per_band{ 16 };
+
+        // the same as BrightFilterShader
+        constexpr float bright_threshold{ 0.7f };
+        constexpr float bright_factor{ 4.0f };
+
+        // the same as BlurShader, a Gaussian blur nine pixels wide
+        constexpr std::array<float, 9> blur_weights{ 0.0162162162f, 0.0540540541f, 0.1216216216f,
+                                                     0.1945945946f, 0.2270270270f, 0.1945945946f,
+                                                     0.1216216216f, 0.0540540541f, 0.0162162162f };
+
+        // what to multiply an RGBA pixel by, which also scales it to 0 to 1 and by a quarter so
+        // that adding four of them averages them
+        inline float brightFactor(const std::uint8_t * const t_pixel)
+        {
+            const float luminance{ ((t_pixel[0] * 0.2126f) + (t_pixel[1] * 0.7152f) +
+                                    (t_pixel[2] * 0.0722f)) /
+                                   255.0f };
+
+            return (
+                std::clamp((luminance - bright_threshold), 0.0f, 1.0f) *
+                (bright_factor / (255.0f * 4.0f)));
+        }
+
+        constexpr std::size_t blur_radius{ 4 };
+        constexpr float blur_multiplier{ 1.25f };
+
+        // plain enough that the compiler vectorizes it, at whatever width the caller targets
+        inline void blurSpan(
+            const std::array<const float *, 9> & t_taps, float * t_dest, const std::size_t t_count)
+        {
+            const float * const tap0{ t_taps[0] };
+            const float * const tap1{ t_taps[1] };
+            const float * const tap2{ t_taps[2] };
+            const float * const tap3{ t_taps[3] };
+            const float * const tap4{ t_taps[4] };
+            const float * const tap5{ t_taps[5] };
+            const float * const tap6{ t_taps[6] };
+            const float * const tap7{ t_taps[7] };
+            const float * const tap8{ t_taps[8] };
+
+            for (std::size_t index{ 0 }; index < t_count; ++index)
+            {
+                t_dest[index] = ((tap0[index] + tap8[index]) * blur_weights[0]) +
+                                ((tap1[index] + tap7[index]) * blur_weights[1]) +
+                                ((tap2[index] + tap6[index]) * blur_weights[2]) +
+                                ((tap3[index] + tap5[index]) * blur_weights[3]) +
+                                (tap4[index] * blur_weights[4]);
+            }
+        }
+
+        void blurSpanDefault(
+            const std::array<const float *, 9> & t_taps, float * t_dest, const std::size_t t_count)
+        {
+            blurSpan(t_taps, t_dest, t_count);
+        }
+
+        GAMEOFLIFE_TARGET_AVX2 void blurSpanAvx2(
+            const std::array<const float *, 9> & t_taps, float * t_dest, const std::size_t t_count)
+        {
+            blurSpan(t_taps, t_dest, t_count);
+        }
+
+        std::size_t clampIndex(const std::ptrdiff_t t_index, const std::size_t t_count)
+        {
+            return static_cast<std::size_t>(
+                std::clamp(t_index, std::ptrdiff_t{ 0 }, static_cast<std::ptrdiff_t>(t_count - 1)));
+        }
+
+        // Stretching to twice the size with pixel centers lined up the way the GPU's bilinear
+        // filtering does puts every new pixel a quarter of the way between two old ones.  So an
+        // even new pixel is 3/4 of old pixel (x / 2) and 1/4 of the one before it, and an odd
+        // one is 3/4 of the same old pixel and 1/4 of the one after it.
+        constexpr float near_weight{ 0.75f };
+        constexpr float far_weight{ 0.25f };
+
+        // the old row or column to take 3/4 and 1/4 of, clamped to the edges
+        struct UpSampleTap
+        {
+            std::size_t near{ 0 };
+            std::size_t far{ 0 };
+        };
+
+        UpSampleTap makeUpSampleTap(const std::size_t t_index, const std::size_t t_count)
+        {
+            const std::size_t near{ std::min((t_index / 2), (t_count - 1)) };
+            if ((t_index % 2) == 0)
+            {
+                return { near, ((near > 0) ? (near - 1) : 0) };
+            }
+            else
+            {
+                return { near, std::min((near + 1), (t_count - 1)) };
+            }
+        }
+
+        // t_dest is one row of the image t_width pixels wide blended between two rows
+        void blendRows(
+            const float * const t_near,
+            const float * const t_far,
+            float * const t_dest,
+            const std::size_t t_width)
+        {
+            for (std::size_t index{ 0 }; index < (t_width * 4); ++index)
+            {
+                t_dest[index] = ((t_near[index] * near_weight) + (t_far[index] * far_weight));
+            }
+        }
+
+        // t_dest is t_row stretched from t_width to t_destWidth pixels
+        void stretchRow(
+            const float * const t_row,
+            const std::size_t t_width,
+            float * const t_dest,
+            const std::size_t t_destWidth)
+        {
+            for (std::size_t x{ 0 }; x < t_destWidth; ++x)
+            {
+                const UpSampleTap tap{ makeUpSampleTap(x, t_width) };
+                for (std::size_t channel{ 0 }; channel < 4; ++channel)
+                {
+                    t_dest[(x * 4) + channel] = ((t_row[(tap.near * 4) + channel] * near_weight) +
+                                                 (t_row[(tap.far * 4) + channel] * far_weight));
+                }
+            }
+        }
+    } // namespace
+
+    void CpuBloom::Image::resize(const std::size_t t_width, const std::size_t t_height)
+    {
+        width  = t_width;
+        height = t_height;
+        values.resize(t_width * t_height * 4);
+    }
+
+    CpuBloom::CpuBloom(const std::size_t t_threadCount)
+        : m_threadPool{ t_threadCount }
+        , m_blurSpan{ (detectSimdLevel() == SimdLevel::Avx2) ? &blurSpanAvx2 : &blurSpanDefault }
+        , m_blurMultiPassCount{ 2 }
+        , m_quality{ util::BloomQuality::High }
+        , m_halfImages{}
+        , m_quarterImages{}
+    {}
+
+    void CpuBloom::apply(
+        const std::uint8_t * const t_source,
+        std::uint8_t * const t_dest,
+        const sf::Vector2u & t_size)
+    {
+        // the same sizes as BloomEffect's textures, which need both halvings to leave something
+        if ((t_size.x < 4) || (t_size.y < 4) || (m_quality == util::BloomQuality::Off))
+        {
+            std::memcpy(t_dest, t_source, (static_cast<std::size_t>(t_size.x) * t_size.y * 4));
+            return;
+        }
+
+        const std::size_t halfWidth{ t_size.x / 2 };
+        const std::size_t halfHeight{ t_size.y / 2 };
+        for (Image & image : m_halfImages)
+        {
+            image.resize(halfWidth, halfHeight);
+        }
+
+        for (Image & image : m_quarterImages)
+        {
+            image.resize((halfWidth / 2), (halfHeight / 2));
+        }
+
+        const std::size_t passCount{ (m_quality == util::BloomQuality::High) ? m_blurMultiPassCount
+                                                                             : 1 };
+
+        brightFilterToHalf(t_source, t_size, m_halfImages[0]);
+        blurMultiPass(m_halfImages[0], m_halfImages[1], passCount);
+
+        if (m_quality != util::BloomQuality::Low)
+        {
+            downSample(m_halfImages[0], m_quarterImages[0]);
+            blurMultiPass(m_quarterImages[0], m_quarterImages[1], passCount);
+            addUpSampled(m_quarterImages[0], m_halfImages[0]);
+        }
+
+        addUpSampledToFrame(m_halfImages[0], t_source, t_dest, t_size);
+    }
+
+    void CpuBloom::brightFilterToHalf(
+        const std::uint8_t * const t_source, const sf::Vector2u & t_size, Image & t_half)
+    {
+        const std::size_t sourceStride{ static_cast<std::size_t>(t_size.x) * 4 };
+
+        m_threadPool.forEachBand(
+            t_half.height,
+            min_rows_per_band,
+            [&](const std::size_t t_beginY, const std::size_t t_endY) {
+                for (std::size_t y{ t_beginY }; y < t_endY; ++y)
+                {
+                    const std::uint8_t * const top{ t_source + ((y * 2) * sourceStride) };
+                    const std::uint8_t * const bottom{ top + sourceStride };
+                    float * const half{ t_half.row(y) };
+
+                    for (std::size_t x{ 0 }; x < t_half.width; ++x)
+                    {
+                        // the average of the four filtered pixels this one covers
+                        const std::size_t left{ x * 8 };
+                        const float topLeft{ brightFactor(top + left) };
+                        const float topRight{ brightFactor(top + left + 4) };
+                        const float bottomLeft{ brightFactor(bottom + left) };
+                        const float bottomRight{ brightFactor(bottom + left + 4) };
+
+                        for (std::size_t channel{ 0 }; channel < 4; ++channel)
+                        {
+                            const std::size_t index{ left + channel };
+                            half[(x * 4) + channel] = ((top[index] * topLeft) +
+                                                       (top[index + 4] * topRight) +
+                                                       (bottom[index] * bottomLeft) +
+                                                       (bottom[index + 4] * bottomRight));
+                        }
+                    }
+                }
+            });
+    }
+
+    void CpuBloom::downSample(const Image & t_source, Image & t_dest)
+    {
+        m_threadPool.forEachBand(
+            t_dest.height,
+            min_rows_per_band,
+            [&](const std::size_t t_beginY, const std::size_t t_endY) {
+                for (std::size_t y{ t_beginY }; y < t_endY; ++y)
+                {
+                    const float * const top{ t_source.row(y * 2) };
+                    const float * const bottom{ t_source.row((y * 2) + 1) };
+                    float * const dest{ t_dest.row(y) };
+
+                    for (std::size_t x{ 0 }; x < t_dest.width; ++x)
+                    {
+                        for (std::size_t channel{ 0 }; channel < 4; ++channel)
+                        {
+                            const std::size_t left{ (x * 8) + channel };
+                            dest[(x * 4) + channel] = ((top[left] + top[left + 4] + bottom[left] +
+                                                        bottom[left + 4]) *
+                                                       0.25f);
+                        }
+                    }
+                }
+            });
+    }
+
+    void CpuBloom::blurMultiPass(Image & t_image, Image & t_temp, const std::size_t t_passCount)
+    {
+        float offset{ 1.0f };
+        for (std::size_t count{ 0 }; count < t_passCount; ++count)
+        {
+            const auto step{ static_cast<std::size_t>(std::max(1.0f, std::round(offset))) };
+            blurVertical(t_image, t_temp, step);
+            blurHorizontal(t_temp, t_image, step);
+            offset *= blur_multiplier;
+        }
+    }
+
+    void CpuBloom::blurVertical(const Image & t_source, Image & t_dest, const std::size_t t_step)
+    {
+        m_threadPool.forEachBand(
+            t_dest.height,
+            min_rows_per_band,
+            [&](const std::size_t t_beginY, const std::size_t t_endY) {
+                for (std::size_t y{ t_beginY }; y < t_endY; ++y)
+                {
+                    // whole rows at a time, with the rows past the edges repeating the edge
+                    std::array<const float *, 9> taps{};
+                    for (std::size_t tap{ 0 }; tap < taps.size(); ++tap)
+                    {
+                        const std::ptrdiff_t offset{ (static_cast<std::ptrdiff_t>(tap) -
+                                                      static_cast<std::ptrdiff_t>(blur_radius)) *
+                                                     static_cast<std::ptrdiff_t>(t_step) };
+
+                        taps[tap] = t_source.row(
+                            clampIndex((static_cast<std::ptrdiff_t>(y) + offset), t_source.height));
+                    }
+
+                    m_blurSpan(taps, t_dest.row(y), (t_dest.width * 4));
+                }
+            });
+    }
+
+    void CpuBloom::blurHorizontal(const Image & t_source, Image & t_dest, const std::size_t t_step)
+    {
+        const std::size_t width{ t_dest.width };
+        const std::size_t edgeWidth{ std::min((blur_radius * t_step), width) };
+        const std::size_t middleEnd{ std::max(edgeWidth, (width - edgeWidth)) };
+
+        m_threadPool.forEachBand(
+            t_dest.height,
+            min_rows_per_band,
+            [&](const std::size_t t_beginY, const std::size_t t_endY) {
+                for (std::size_t y{ t_beginY }; y < t_endY; ++y)
+                {
+                    const float * const source{ t_source.row(y) };
+                    float * const dest{ t_dest.row(y) };
+
+                    // the middle never reaches past either edge, so it's one vectorized span
+                    if (middleEnd > edgeWidth)
+                    {
+                        std::array<const float *, 9> taps{};
+                        for (std::size_t tap{ 0 }; tap < taps.size(); ++tap)
+                        {
+                            taps[tap] = (source + ((edgeWidth + (tap * t_step)) * 4) -
+                                         (blur_radius * t_step * 4));
+                        }
+
+                        m_blurSpan(taps, (dest + (edgeWidth * 4)), ((middleEnd - edgeWidth) * 4));
+                    }
+
+                    // the edges repeat the edge pixels past them, like a clamped texture
+                    const auto blurEdge{ [&](const std::size_t t_beginX, const std::size_t t_endX) {
+                        for (std::size_t x{ t_beginX }; x < t_endX; ++x)
+                        {
+                            for (std::size_t channel{ 0 }; channel < 4; ++channel)
+                            {
+                                float sum{ 0.0f };
+                                for (std::size_t tap{ 0 }; tap < blur_weights.size(); ++tap)
+                                {
+                                    const std::ptrdiff_t sourceX{
+                                        static_cast<std::ptrdiff_t>(x) +
+                                        ((static_cast<std::ptrdiff_t>(tap) -
+                                          static_cast<std::ptrdiff_t>(blur_radius)) *
+                                         static_cast<std::ptrdiff_t>(t_step))
+                                    };
+
+                                    sum += (source[(clampIndex(sourceX, width) * 4) + channel] *
+                                            blur_weights[tap]);
+                                }
+
+                                dest[(x * 4) + channel] = sum;
+                            }
+                        }
+                    } };
+
+                    if (middleEnd > edgeWidth)
+                    {
+                        blurEdge(0, edgeWidth);
+                        blurEdge(middleEnd, width);
+                    }
+                    else
+                    {
+                        blurEdge(0, width);
+                    }
+                }
+            });
+    }
+
+    void CpuBloom::addUpSampled(const Image & t_source, Image & t_dest)
+    {
+        m_threadPool.forEachBand(
+            t_dest.height,
+            min_rows_per_band,
+            [&](const std::size_t t_beginY, const std::size_t t_endY) {
+                std::vector<float> blended(t_source.width * 4);
+                std::vector<float> stretched(t_dest.width * 4);
+
+                for (std::size_t y{ t_beginY }; y < t_endY; ++y)
+                {
+                    const UpSampleTap tap{ makeUpSampleTap(y, t_source.height) };
+                    blendRows(
+                        t_source.row(tap.near),
+                        t_source.row(tap.far),
+                        blended.data(),
+                        t_source.width);
+
+                    stretchRow(blended.data(), t_source.width, stretched.data(), t_dest.width);
+
+                    float * const dest{ t_dest.row(y) };
+                    for (std::size_t index{ 0 }; index < stretched.size(); ++index)
+                    {
+                        dest[index] += stretched[index];
+                    }
+                }
+            });
+    }
+
+    void CpuBloom::addUpSampledToFrame(
+        const Image & t_half,
+        const std::uint8_t * const t_source,
+        std::uint8_t * const t_dest,
+        const sf::Vector2u & t_size)
+    {
+        const std::size_t stride{ static_cast<std::size_t>(t_size.x) * 4 };
+
+        m_threadPool.forEachBand(
+            t_size.y,
+            min_rows_per_band,
+            [&](const std::size_t t_beginY, const std::size_t t_endY) {
+                std::vector<float> blended(t_half.width * 4);
+                std::vector<float> stretched(stride);
+
+                for (std::size_t y{ t_beginY }; y < t_endY; ++y)
+                {
+                    const UpSampleTap tap{ makeUpSampleTap(y, t_half.height) };
+                    blendRows(
+                        t_half.row(tap.near), t_half.row(tap.far), blended.data(), t_half.width);
+                    stretchRow(blended.data(), t_half.width, stretched.data(), t_size.x);
+
+                    const std::uint8_t * const source{ t_source + (y * stride) };
+                    std::uint8_t * const dest{ t_dest + (y * stride) };
+                    for (std::size_t index{ 0 }; index < stride; ++index)
+                    {
+                        const float value{ static_cast<float>(source[index]) +
+                                           (stretched[index] * 255.0f) };
+
+                        dest[index] = static_cast<std::uint8_t>(std::min(255.0f, (value + 0.5f)));
+                    }
+                }
+            });
+    }
+
+} // namespace gameoflife
@@ -0,0 +1,110 @@
+#ifndef CPU_BLOOM_HPP_INCLUDED
+#define CPU_BLOOM_HPP_INCLUDED
+//
+// cpu-bloom.hpp
+//
+#include "bloom-quality.hpp"
+#include "frame-bloom.hpp"
+#include "thread-pool.hpp"
+
+#include <SFML/System/Vector2.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace gameoflife
+{
+
+    // The glow of util::BloomEffect's High quality for machines without shaders, on a frame
+    // read back into memory.  The same bright filter, a downsample to half size, the blur
+    // passes, another downsample to quarter size and more blur passes, then both added back
+    // onto the frame.  The blur offsets grow the same way but are rounded to whole pixels, so
+    // the glow looks the same without needing to be exact.
+    //
+    // The cheaper qualities trim that instead of copying the GPU's dual filter.  Medium blurs
+    // each size only once, and Low skips the quarter size too, so its glow doesn't reach as far.
+    //
+    // It is the util::IFrameBloom that Coordinator gives util::BloomEffectHelper to use when
+    // there are no shaders, and OffscreenRenderer uses it directly.
+    //
+    // Every pass is split into bands of rows across a ThreadPool.  The blur, which is most of
+    // the work, is in one loop over plain floats that the compiler vectorizes, built twice so
+    // CPUs with AVX2 get twice as many floats at a time.
+    class CpuBloom : public util::IFrameBloom
+    {
+      public:
+        // zero means one per hardware thread
+        explicit CpuBloom(const std::size_t t_threadCount);
+        virtual ~CpuBloom() override = default;
+
+        std::size_t blurMultiPassCount() const { return m_blurMultiPassCount; }
+        void blurMultiPassCount(const std::size_t t_count) override
+        {
+            m_blurMultiPassCount = t_count;
+        }
+
+        // Off only copies
+        util::BloomQuality quality() const { return m_quality; }
+        void quality(const util::BloomQuality t_quality) override { m_quality = t_quality; }
+
+        // Both are RGBA, (t_size.x * t_size.y * 4) bytes, and t_dest is t_source plus the glow.
+        // Sizes smaller than 4x4 are only copied.
+        void apply(
+            const std::uint8_t * const t_source,
+            std::uint8_t * const t_dest,
+            const sf::Vector2u & t_size) override;
+
+      private:
+        // RGBA as floats from 0 to 1, row after row
+        struct Image
+        {
+            std::size_t width{ 0 };
+            std::size_t height{ 0 };
+            std::vector<float> values;
+
+            void resize(const std::size_t t_width, const std::size_t t_height);
+            float * row(const std::size_t t_y) { return (values.data() + (t_y * width * 4)); }
+
+            const float * row(const std::size_t t_y) const
+            {
+                return (values.data() + (t_y * width * 4));
+            }
+        };
+
+        // nine source pointers that all step one float at a time, see blurSpan() in the .cpp
+        using BlurSpanFunc_t =
+            void (*)(const std::array<const float *, 9> &, float *, const std::size_t);
+
+        void brightFilterToHalf(
+            const std::uint8_t * const t_source, const sf::Vector2u & t_size, Image & t_half);
+
+        void downSample(const Image & t_source, Image & t_dest);
+
+        // t_image and t_temp must be the same size, and t_image gets the result
+        void blurMultiPass(Image & t_image, Image & t_temp, const std::size_t t_passCount);
+        void blurVertical(const Image & t_source, Image & t_dest, const std::size_t t_step);
+        void blurHorizontal(const Image & t_source, Image & t_dest, const std::size_t t_step);
+
+        // t_dest += t_source, which is half as big and is stretched to fit
+        void addUpSampled(const Image & t_source, Image & t_dest);
+
+        void addUpSampledToFrame(
+            const Image & t_half,
+            const std::uint8_t * const t_source,
+            std::uint8_t * const t_dest,
+            const sf::Vector2u & t_size);
+
+      private:
+        ThreadPool m_threadPool;
+        BlurSpanFunc_t m_blurSpan;
+        std::size_t m_blurMultiPassCount;
+        util::BloomQuality m_quality;
+        std::array<Image, 2> m_halfImages;
+        std::array<Image, 2> m_quarterImages;
+    };
+
+} // namespace gameoflife
+
+#endif // CPU_BLOOM_HPP_INCLUDED
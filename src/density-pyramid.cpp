@@ -0,0 +1,171 @@
+//
+// density-pyramid.cpp
+//
+#include "density-pyramid.hpp"
+
+#include <utility>
+
+namespace gameoflife
+{
+
+    DensityPyramid::DensityPyramid()
+        : m_cellCounts{}
+        , m_levels{}
+        , m_changedRows{}
+    {}
+
+    void DensityPyramid::update(
+        const CellBuffer & t_cells, const std::vector<std::uint8_t> & t_changedRows)
+    {
+        updateLevels(t_cells, &t_changedRows);
+    }
+
+    void DensityPyramid::update(const CellBuffer & t_cells) { updateLevels(t_cells, nullptr); }
+
+    void DensityPyramid::updateLevels(
+        const CellBuffer & t_cells, const std::vector<std::uint8_t> * const t_changedRowsPtr)
+    {
+        const bool isResized{ (t_cells.width() != m_cellCounts.x) ||
+                              (t_cells.height() != m_cellCounts.y) };
+
+        if (isResized)
+        {
+            resize(t_cells.width(), t_cells.height());
+        }
+
+        for (std::size_t index{ 0 }; index < m_levels.size(); ++index)
+        {
+            DensityLevel & level{ m_levels[index] };
+            std::vector<bool> & changedRows{ m_changedRows[index] };
+
+            for (std::size_t y{ 0 }; y < level.height; ++y)
+            {
+                if (index == 0)
+                {
+                    const std::size_t cellY{ y * 2 };
+
+                    const bool isCellRowChanged{
+                        isResized || (t_changedRowsPtr == nullptr) ||
+                        ((*t_changedRowsPtr)[cellY] != 0) ||
+                        (((cellY + 1) < t_cells.height()) && ((*t_changedRowsPtr)[cellY + 1] != 0))
+                    };
+
+                    changedRows[y] = (isCellRowChanged && updateFirstRow(t_cells, y));
+                    continue;
+                }
+
+                // after a resize every row is new, and the densities are all still zero
+                const std::vector<bool> & changedBelow{ m_changedRows[index - 1] };
+                const std::size_t belowY{ y * 2 };
+
+                const bool isBelowChanged{
+                    isResized || changedBelow[belowY] ||
+                    (((belowY + 1) < changedBelow.size()) && changedBelow[belowY + 1])
+                };
+
+                changedRows[y] = (isBelowChanged && updateRow(index, y));
+            }
+        }
+    }
+
+    std::size_t DensityPyramid::halve(const std::size_t t_count) { return ((t_count + 1) / 2); }
+
+    void DensityPyramid::resize(const std::size_t t_width, const std::size_t t_height)
+    {
+        m_cellCounts = { t_width, t_height };
+        m_levels.clear();
+        m_changedRows.clear();
+
+        if ((0 == t_width) || (0 == t_height))
+        {
+            return;
+        }
+
+        std::size_t width{ t_width };
+        std::size_t height{ t_height };
+        while ((width > 1) || (height > 1))
+        {
+            width  = halve(width);
+            height = halve(height);
+
+            DensityLevel level;
+            level.width  = width;
+            level.height = height;
+            level.densities.assign((width * height), 0);
+
+            m_levels.push_back(std::move(level));
+            m_changedRows.push_back(std::vector<bool>(height, true));
+        }
+    }
+
+    bool DensityPyramid::updateFirstRow(const CellBuffer & t_cells, const std::size_t t_y)
+    {
+        DensityLevel & level{ m_levels.front() };
+        std::uint8_t * const densities{ level.densities.data() + (t_y * level.width) };
+
+        const CellType_t * const top{ t_cells.row(t_y * 2) };
+        const bool hasBottom{ ((t_y * 2) + 1) < t_cells.height() };
+        const CellType_t * const bottom{ hasBottom ? t_cells.row((t_y * 2) + 1) : nullptr };
+
+        bool isChanged{ false };
+        for (std::size_t x{ 0 }; x < level.width; ++x)
+        {
+            const std::size_t left{ x * 2 };
+            const bool hasRight{ (left + 1) < t_cells.width() };
+
+            unsigned count{ top[left] };
+            count += (hasRight ? top[left + 1] : 0u);
+            if (hasBottom)
+            {
+                count += bottom[left];
+                count += (hasRight ? bottom[left + 1] : 0u);
+            }
+
+            // so 0 to 4 live cells become 0 to 255, rounded
+            const auto density{ static_cast<std::uint8_t>(((count * 255u) + 2u) / 4u) };
+            if (densities[x] != density)
+            {
+                densities[x] = density;
+                isChanged    = true;
+            }
+        }
+
+        return isChanged;
+    }
+
+    bool DensityPyramid::updateRow(const std::size_t t_levelIndex, const std::size_t t_y)
+    {
+        const DensityLevel & below{ m_levels[t_levelIndex - 1] };
+        DensityLevel & level{ m_levels[t_levelIndex] };
+        std::uint8_t * const densities{ level.densities.data() + (t_y * level.width) };
+
+        const std::uint8_t * const top{ below.row(t_y * 2) };
+        const bool hasBottom{ ((t_y * 2) + 1) < below.height };
+        const std::uint8_t * const bottom{ hasBottom ? below.row((t_y * 2) + 1) : nullptr };
+
+        bool isChanged{ false };
+        for (std::size_t x{ 0 }; x < level.width; ++x)
+        {
+            const std::size_t left{ x * 2 };
+            const bool hasRight{ (left + 1) < below.width };
+
+            unsigned sum{ top[left] };
+            sum += (hasRight ? top[left + 1] : 0u);
+            if (hasBottom)
+            {
+                sum += bottom[left];
+                sum += (hasRight ? bottom[left + 1] : 0u);
+            }
+
+            const auto density{ static_cast<std::uint8_t>((sum + 2u) / 4u) };
+            if (densities[x] != density)
+            {
+                densities[x] = density;
+                isChanged    = true;
+            }
+        }
+
+        return isChanged;
+    }
+
+} // namespace gameoflife
@@ -0,0 +1,81 @@
+#ifndef DENSITY_PYRAMID_HPP_INCLUDED
+#define DENSITY_PYRAMID_HPP_INCLUDED
+//
+// density-pyramid.hpp
+//
+#include "cell-buffer.hpp"
+
+#include <SFML/System/Vector2.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace gameoflife
+{
+
+    // how much of each square block of cells is alive, from 0 for none to 255 for all of them
+    struct DensityLevel
+    {
+        std::size_t width{ 0 };
+        std::size_t height{ 0 };
+        std::vector<std::uint8_t> densities; // row after row, no halo
+
+        const std::uint8_t * row(const std::size_t t_y) const
+        {
+            return (densities.data() + (t_y * width));
+        }
+    };
+
+    // Mip levels of a board's density, so a board zoomed out past one cell per pixel can be
+    // drawn from the level with about one block per pixel instead of from every cell.  Level 1
+    // is blocks of 2x2 cells, level 2 of 4x4, and so on up to a level that is a single block.
+    // Blocks that hang past the right or bottom edge count the missing cells as dead.
+    //
+    // update() is only incremental when it is told which rows of cells changed.  Then level 1
+    // only rebuilds the rows over those, and each level above only the rows over rows that
+    // changed in the level below, so a board with little going on is cheap to keep current.
+    class DensityPyramid
+    {
+      public:
+        DensityPyramid();
+
+        // t_changedRows has one entry per row of t_cells, nonzero if that row changed since the
+        // last update(), and is ignored when t_cells is a different size than last time
+        void update(const CellBuffer & t_cells, const std::vector<std::uint8_t> & t_changedRows);
+
+        // rebuilds all of level 1, for when which rows changed isn't known
+        void update(const CellBuffer & t_cells);
+
+        // zero until the first update(), and always zero for an empty board
+        std::size_t levelCount() const { return m_levels.size(); }
+
+        // t_level is from 1 to levelCount()
+        const DensityLevel & level(const std::size_t t_level) const
+        {
+            return m_levels[t_level - 1];
+        }
+
+      private:
+        // the size of each level from the size of the one below
+        static std::size_t halve(const std::size_t t_count);
+
+        void resize(const std::size_t t_width, const std::size_t t_height);
+
+        // every row of cells changed if t_changedRowsPtr is null
+        void updateLevels(
+            const CellBuffer & t_cells, const std::vector<std::uint8_t> * const t_changedRowsPtr);
+
+        // both return true if any density changed, and only write the ones that did
+        bool updateFirstRow(const CellBuffer & t_cells, const std::size_t t_y);
+        bool updateRow(const std::size_t t_levelIndex, const std::size_t t_y);
+
+      private:
+        sf::Vector2<std::size_t> m_cellCounts; // of the board the levels were sized for
+        std::vector<DensityLevel> m_levels;
+        std::vector<std::vector<bool>> m_changedRows; // of each level, by the last update()
+    };
+
+} // namespace gameoflife
+
+#endif // DENSITY_PYRAMID_HPP_INCLUDED
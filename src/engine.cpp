@@ -0,0 +1,119 @@
+//
+// engine.cpp
+//
+#include "engine.hpp"
+
+#include "bit-engine.hpp"
+#include "config.hpp"
+#include "hash-life-engine.hpp"
+#include "sparse-engine.hpp"
+#include "table-engine.hpp"
+
+#include <stdexcept>
+
+namespace gameoflife
+{
+
+    namespace
+    {
+        constexpr EngineType all_engine_types[] = { EngineType::Reference, EngineType::BitPacked,
+                                                    EngineType::Tiled,     EngineType::HashLife,
+                                                    EngineType::Sparse,    EngineType::Table };
+    } // namespace
+
+    std::string_view toString(const EngineType t_type)
+    {
+        switch (t_type)
+        {
+            case EngineType::Reference: return "reference";
+            case EngineType::BitPacked: return "bit-packed";
+            case EngineType::Tiled: return "bit-packed-tiled";
+            case EngineType::HashLife: return "hashlife";
+            case EngineType::Sparse: return "sparse";
+            case EngineType::Table: return "lookup-table";
+            default: return "";
+        }
+    }
+
+    EngineType parseEngineType(const std::string_view t_name)
+    {
+        for (const EngineType type : all_engine_types)
+        {
+            if (toString(type) == t_name)
+            {
+                return type;
+            }
+        }
+
+        throw std::runtime_error(
+            "Unknown engine \"" + std::string{ t_name } + "\", try one of: " + engineTypeNames());
+    }
+
+    std::string engineTypeNames()
+    {
+        std::string names;
+        for (const EngineType type : all_engine_types)
+        {
+            if (!names.empty())
+            {
+                names += ", ";
+            }
+
+            names += toString(type);
+        }
+
+        return names;
+    }
+
+    std::unique_ptr<IEngine> makeEngine(const Config & t_config, ThreadPool & t_threadPool)
+    {
+        const Rule rule{ parseRule(t_config.rule) };
+
+        const bool isUnbounded{ (t_config.engine == EngineType::HashLife) ||
+                                (t_config.engine == EngineType::Sparse) };
+
+        if (isUnbounded && rule.isBornFromNothing())
+        {
+            throw std::runtime_error(
+                "The rule " + toString(rule) +
+                " makes empty space come alive, which the unbounded engines can't do.");
+        }
+
+        if (isUnbounded && t_config.is_toroidal)
+        {
+            throw std::runtime_error(
+                "The unbounded engines (HashLife and Sparse) have no edges to wrap around.");
+        }
+
+        switch (t_config.engine)
+        {
+            case EngineType::BitPacked:
+            {
+                return std::make_unique<BitEngine>(
+                    t_threadPool, rule, t_config.is_toroidal, false);
+            }
+
+            case EngineType::Tiled:
+            {
+                return std::make_unique<BitEngine>(t_threadPool, rule, t_config.is_toroidal, true);
+            }
+
+            case EngineType::Table:
+            {
+                return std::make_unique<TableEngine>(t_threadPool, rule, t_config.is_toroidal);
+            }
+
+            case EngineType::HashLife:
+            {
+                return std::make_unique<HashLifeEngine>(
+                    rule, (t_config.hashlife_memory_limit_mb * 1024 * 1024));
+            }
+
+            case EngineType::Sparse: return std::make_unique<SparseEngine>(t_threadPool, rule);
+
+            case EngineType::Reference:
+            default: return {};
+        }
+    }
+
+} // namespace gameoflife
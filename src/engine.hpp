@@ -0,0 +1,71 @@
+#ifndef ENGINE_HPP_INCLUDED
+#define ENGINE_HPP_INCLUDED
+//
+// engine.hpp
+//
+#include "cell-buffer.hpp"
+#include "rule.hpp"
+#include "thread-pool.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace gameoflife
+{
+
+    enum class EngineType
+    {
+        Reference, // Grid's own one-byte-per-cell processStep()
+        BitPacked, // see bit-engine.hpp
+        Tiled,     // BitPacked that skips tiles which can't change
+        HashLife,  // see hash-life-engine.hpp
+        Sparse,    // see sparse-engine.hpp
+        Table      // see table-engine.hpp
+    };
+
+    // the same names the engines return from IEngine::name(), plus "reference"
+    std::string_view toString(const EngineType t_type);
+
+    // throws std::runtime_error if the name isn't one of the above
+    EngineType parseEngineType(const std::string_view t_name);
+
+    // all of the names above, separated by commas
+    std::string engineTypeNames();
+
+    struct Config;
+
+    // An alternative simulation that Grid can hand its cells to.  The engine keeps its own
+    // representation between steps, so Grid only calls load() after the cells were edited.
+    class IEngine
+    {
+      public:
+        virtual ~IEngine() = default;
+
+        virtual std::string_view name() const = 0;
+
+        virtual void load(const CellBuffer & t_cells) = 0;
+        virtual void store(CellBuffer & t_cells) const = 0;
+
+        // about how much memory the engine's own copy of the board uses, see the benchmark
+        virtual std::size_t byteCount() const = 0;
+
+        virtual void processStep() = 0;
+
+        // engines that can skip ahead faster than one generation at a time override this
+        virtual void processSteps(const std::size_t t_count)
+        {
+            for (std::size_t count{ 0 }; count < t_count; ++count)
+            {
+                processStep();
+            }
+        }
+    };
+
+    // returns nullptr for EngineType::Reference, the thread pool must outlive the engine
+    std::unique_ptr<IEngine> makeEngine(const Config & t_config, ThreadPool & t_threadPool);
+
+} // namespace gameoflife
+
+#endif // ENGINE_HPP_INCLUDED
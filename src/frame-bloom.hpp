@@ -0,0 +1,33 @@
+#ifndef FRAME_BLOOM_HPP_INCLUDED
+#define FRAME_BLOOM_HPP_INCLUDED
+//
+// frame-bloom.hpp
+//
+#include "bloom-quality.hpp"
+
+#include <SFML/System/Vector2.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace util
+{
+    // A bloom done on a frame's pixels in memory instead of with shaders, for
+    // BloomEffectHelper to fall back on when the video card has none.
+    class IFrameBloom
+    {
+      public:
+        virtual ~IFrameBloom() = default;
+
+        virtual void quality(const BloomQuality quality) = 0;
+        virtual void blurMultiPassCount(const std::size_t count) = 0;
+
+        // both are RGBA, (size.x * size.y * 4) bytes, and dest is source plus the glow
+        virtual void apply(
+            const std::uint8_t * const source,
+            std::uint8_t * const dest,
+            const sf::Vector2u & size) = 0;
+    };
+} // namespace util
+
+#endif // FRAME_BLOOM_HPP_INCLUDED
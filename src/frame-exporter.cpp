@@ -0,0 +1,417 @@
+//
+// frame-exporter.cpp
+//
+#include "frame-exporter.hpp"
+
+#include <SFML/Graphics/Image.hpp>
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+namespace gameoflife
+{
+
+    namespace
+    {
+        // the rate Y4M players show the frames at, which has nothing to do with how fast the
+        // generations were stepped
+        constexpr unsigned y4m_frames_per_second{ 30 };
+
+        std::uint8_t toByte(const float t_value)
+        {
+            return static_cast<std::uint8_t>(std::clamp((t_value + 0.5f), 0.0f, 255.0f));
+        }
+    } // namespace
+
+    std::string_view toString(const FrameFormat t_format)
+    {
+        switch (t_format)
+        {
+            case FrameFormat::Png: return "png";
+            case FrameFormat::Y4m: return "y4m";
+            default: return "";
+        }
+    }
+
+    FrameFormat parseFrameFormat(const std::string_view t_name)
+    {
+        for (const FrameFormat format : { FrameFormat::Png, FrameFormat::Y4m })
+        {
+            if (toString(format) == t_name)
+            {
+                return format;
+            }
+        }
+
+        throw std::runtime_error(
+            "Unknown frame format \"" + std::string{ t_name } + "\", try png or y4m.");
+    }
+
+    void drawCellsToFrame(
+        const CellBuffer & t_cells,
+        const sf::Color & t_colorOn,
+        const sf::Color & t_colorOff,
+        Frame & t_frame)
+    {
+        t_frame.size = { static_cast<unsigned>(t_cells.width()),
+                         static_cast<unsigned>(t_cells.height()) };
+
+        t_frame.pixels.resize(t_cells.width() * t_cells.height() * 4);
+
+        const std::uint8_t on[4]{ t_colorOn.r, t_colorOn.g, t_colorOn.b, t_colorOn.a };
+        const std::uint8_t off[4]{ t_colorOff.r, t_colorOff.g, t_colorOff.b, t_colorOff.a };
+
+        std::uint8_t * pixel{ t_frame.pixels.data() };
+        for (std::size_t y{ 0 }; y < t_cells.height(); ++y)
+        {
+            const CellType_t * const row{ t_cells.row(y) };
+            for (std::size_t x{ 0 }; x < t_cells.width(); ++x)
+            {
+                const std::uint8_t * const color{ (row[x] == 0) ? off : on };
+                std::copy(color, (color + 4), pixel);
+                pixel += 4;
+            }
+        }
+    }
+
+    FrameExporter::FrameExporter(
+        const std::filesystem::path & t_directory,
+        const FrameFormat t_format,
+        const std::size_t t_threadCount,
+        const std::size_t t_maxQueuedCount)
+        : m_directory{ t_directory }
+        , m_format{ t_format }
+        , m_maxQueuedCount{ std::max(std::size_t{ 1 }, t_maxQueuedCount) }
+        , m_mutex{}
+        , m_queueCondition{}
+        , m_spaceCondition{}
+        , m_queue{}
+        , m_spareFrames{}
+        , m_submittedCount{ 0 }
+        , m_writtenCount{ 0 }
+        , m_stallCount{ 0 }
+        , m_isStopping{ false }
+        , m_exceptionPtr{}
+        , m_y4mMutex{}
+        , m_y4mCondition{}
+        , m_y4mNextIndex{ 0 }
+        , m_y4mFile{}
+        , m_y4mSize{}
+        , m_workers{}
+    {
+        std::size_t threadCount{ t_threadCount };
+        if (0 == threadCount)
+        {
+            threadCount = std::max(1u, std::thread::hardware_concurrency());
+        }
+
+        m_workers.reserve(threadCount);
+        for (std::size_t index{ 0 }; index < threadCount; ++index)
+        {
+            m_workers.emplace_back(&FrameExporter::workerLoop, this);
+        }
+    }
+
+    FrameExporter::~FrameExporter() { stopWorkers(); }
+
+    Frame FrameExporter::spareFrame()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_spareFrames.empty())
+        {
+            return {};
+        }
+
+        Frame frame{ std::move(m_spareFrames.back()) };
+        m_spareFrames.pop_back();
+        return frame;
+    }
+
+    void FrameExporter::submit(Frame && t_frame)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            if (m_queue.size() >= m_maxQueuedCount)
+            {
+                ++m_stallCount;
+                m_spaceCondition.wait(lock, [&]() {
+                    return ((m_queue.size() < m_maxQueuedCount) || m_exceptionPtr);
+                });
+            }
+
+            if (m_exceptionPtr)
+            {
+                std::rethrow_exception(m_exceptionPtr);
+            }
+
+            m_queue.push_back({ m_submittedCount, std::move(t_frame) });
+            ++m_submittedCount;
+        }
+
+        m_queueCondition.notify_one();
+    }
+
+    void FrameExporter::finish()
+    {
+        stopWorkers();
+
+        if (m_y4mFile.is_open())
+        {
+            m_y4mFile.close();
+            if (!m_y4mFile)
+            {
+                throw std::runtime_error("FrameExporter could not finish writing the Y4M file.");
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_exceptionPtr)
+        {
+            std::rethrow_exception(m_exceptionPtr);
+        }
+    }
+
+    std::size_t FrameExporter::writtenCount() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_writtenCount;
+    }
+
+    std::size_t FrameExporter::stallCount() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_stallCount;
+    }
+
+    void FrameExporter::workerLoop()
+    {
+        while (true)
+        {
+            Job job;
+
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_queueCondition.wait(lock, [&]() { return (m_isStopping || !m_queue.empty()); });
+
+                // stopping still finishes whatever is queued
+                if (m_queue.empty())
+                {
+                    return;
+                }
+
+                job = std::move(m_queue.front());
+                m_queue.pop_front();
+            }
+
+            m_spaceCondition.notify_one();
+
+            std::exception_ptr exceptionPtr;
+            try
+            {
+                if (m_format == FrameFormat::Y4m)
+                {
+                    writeY4m(job);
+                }
+                else
+                {
+                    writePng(job.frame);
+                }
+            }
+            catch (...)
+            {
+                exceptionPtr = std::current_exception();
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (exceptionPtr)
+                {
+                    if (!m_exceptionPtr)
+                    {
+                        m_exceptionPtr = exceptionPtr;
+                    }
+                }
+                else
+                {
+                    ++m_writtenCount;
+                }
+
+                if (m_spareFrames.size() < m_maxQueuedCount)
+                {
+                    m_spareFrames.push_back(std::move(job.frame));
+                }
+            }
+
+            // so a submit() waiting on a full queue sees the error
+            if (exceptionPtr)
+            {
+                m_spaceCondition.notify_all();
+            }
+        }
+    }
+
+    void FrameExporter::stopWorkers()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_isStopping = true;
+        }
+
+        m_queueCondition.notify_all();
+
+        for (std::thread & worker : m_workers)
+        {
+            if (worker.joinable())
+            {
+                worker.join();
+            }
+        }
+    }
+
+    void FrameExporter::writePng(const Frame & t_frame) const
+    {
+        // zero padded so the files sort in order
+        std::ostringstream name;
+        name << "frame-" << std::setw(10) << std::setfill('0') << t_frame.generation << ".png";
+
+        const sf::Image image(t_frame.size, t_frame.pixels.data());
+        if (!image.saveToFile(m_directory / name.str()))
+        {
+            throw std::runtime_error(
+                "FrameExporter could not write " + (m_directory / name.str()).string() + ".");
+        }
+    }
+
+    void FrameExporter::writeY4m(const Job & t_job)
+    {
+        // the slow part, done before waiting for this frame's turn
+        std::exception_ptr exceptionPtr;
+        std::vector<std::uint8_t> planes;
+        try
+        {
+            planes = encodeY4m(t_job.frame);
+        }
+        catch (...)
+        {
+            exceptionPtr = std::current_exception();
+        }
+
+        {
+            std::unique_lock<std::mutex> lock(m_y4mMutex);
+            m_y4mCondition.wait(lock, [&]() { return (m_y4mNextIndex == t_job.index); });
+
+            // a frame that failed still takes its turn, or every later one would wait forever
+            try
+            {
+                if (!exceptionPtr)
+                {
+                    const sf::Vector2u & size{ t_job.frame.size };
+                    if (!m_y4mFile.is_open())
+                    {
+                        const std::filesystem::path path{ m_directory / "frames.y4m" };
+                        m_y4mFile.open(path, std::ios::binary);
+                        if (!m_y4mFile)
+                        {
+                            throw std::runtime_error(
+                                "FrameExporter could not create " + path.string() + ".");
+                        }
+
+                        m_y4mSize = size;
+                        m_y4mFile << "YUV4MPEG2 W" << size.x << " H" << size.y << " F"
+                                  << y4m_frames_per_second << ":1 Ip A1:1 C420jpeg\n";
+                    }
+
+                    if (size != m_y4mSize)
+                    {
+                        throw std::runtime_error(
+                            "FrameExporter can't change the size of a Y4M video part way.");
+                    }
+
+                    m_y4mFile << "FRAME\n";
+                    m_y4mFile.write(
+                        reinterpret_cast<const char *>(planes.data()),
+                        static_cast<std::streamsize>(planes.size()));
+
+                    if (!m_y4mFile)
+                    {
+                        throw std::runtime_error("FrameExporter could not write the Y4M file.");
+                    }
+                }
+            }
+            catch (...)
+            {
+                exceptionPtr = std::current_exception();
+            }
+
+            ++m_y4mNextIndex;
+        }
+
+        m_y4mCondition.notify_all();
+
+        if (exceptionPtr)
+        {
+            std::rethrow_exception(exceptionPtr);
+        }
+    }
+
+    std::vector<std::uint8_t> FrameExporter::encodeY4m(const Frame & t_frame)
+    {
+        const std::size_t width{ t_frame.size.x };
+        const std::size_t height{ t_frame.size.y };
+        const std::size_t chromaWidth{ (width + 1) / 2 };
+        const std::size_t chromaHeight{ (height + 1) / 2 };
+
+        std::vector<std::uint8_t> planes((width * height) + (chromaWidth * chromaHeight * 2));
+        std::uint8_t * const luma{ planes.data() };
+        std::uint8_t * const blue{ luma + (width * height) };
+        std::uint8_t * const red{ blue + (chromaWidth * chromaHeight) };
+
+        const std::uint8_t * const pixels{ t_frame.pixels.data() };
+        for (std::size_t index{ 0 }; index < (width * height); ++index)
+        {
+            const std::uint8_t * const pixel{ pixels + (index * 4) };
+            luma[index] = toByte((pixel[0] * 0.299f) + (pixel[1] * 0.587f) + (pixel[2] * 0.114f));
+        }
+
+        // each chroma sample is of the average of the (up to) four pixels it covers
+        for (std::size_t y{ 0 }; y < chromaHeight; ++y)
+        {
+            const std::size_t top{ y * 2 };
+            const std::size_t bottom{ std::min((top + 1), (height - 1)) };
+
+            for (std::size_t x{ 0 }; x < chromaWidth; ++x)
+            {
+                const std::size_t left{ x * 2 };
+                const std::size_t right{ std::min((left + 1), (width - 1)) };
+
+                float rgb[3]{ 0.0f, 0.0f, 0.0f };
+                for (const std::size_t pixelY : { top, bottom })
+                {
+                    for (const std::size_t pixelX : { left, right })
+                    {
+                        const std::uint8_t * const pixel{ pixels +
+                                                          (((pixelY * width) + pixelX) * 4) };
+
+                        for (std::size_t channel{ 0 }; channel < 3; ++channel)
+                        {
+                            rgb[channel] += (pixel[channel] * 0.25f);
+                        }
+                    }
+                }
+
+                const std::size_t index{ (y * chromaWidth) + x };
+                blue[index] = toByte(
+                    128.0f - (rgb[0] * 0.168736f) - (rgb[1] * 0.331264f) + (rgb[2] * 0.5f));
+
+                red[index] = toByte(
+                    128.0f + (rgb[0] * 0.5f) - (rgb[1] * 0.418688f) - (rgb[2] * 0.081312f));
+            }
+        }
+
+        return planes;
+    }
+
+} // namespace gameoflife
@@ -0,0 +1,137 @@
+#ifndef FRAME_EXPORTER_HPP_INCLUDED
+#define FRAME_EXPORTER_HPP_INCLUDED
+//
+// frame-exporter.hpp
+//
+#include "cell-buffer.hpp"
+
+#include <SFML/Graphics/Color.hpp>
+#include <SFML/System/Vector2.hpp>
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace gameoflife
+{
+
+    enum class FrameFormat
+    {
+        Png, // one numbered file per frame
+        Y4m  // every frame in one raw YUV 4:2:0 video that ffmpeg and most players can read
+    };
+
+    std::string_view toString(const FrameFormat t_format);
+
+    // throws std::runtime_error if t_name isn't one of the toString() names
+    FrameFormat parseFrameFormat(const std::string_view t_name);
+
+    // RGBA pixels, row after row
+    struct Frame
+    {
+        std::size_t generation{ 0 };
+        sf::Vector2u size;
+        std::vector<std::uint8_t> pixels;
+    };
+
+    // one pixel per cell, t_colorOn or t_colorOff, and t_frame's pixels are reused
+    void drawCellsToFrame(
+        const CellBuffer & t_cells,
+        const sf::Color & t_colorOn,
+        const sf::Color & t_colorOff,
+        Frame & t_frame);
+
+    // Writes frames to disk on worker threads of its own, so encoding them never holds up
+    // whoever makes them unless they are made faster than the workers can keep up.  The queue
+    // holds at most t_maxQueuedCount frames, and submit() waits while it is full, so memory
+    // never grows past that many frames plus the one each worker is busy with.
+    //
+    // Workers encode in parallel, but a Y4m video gets its frames in the order submitted.  The
+    // first error a worker hits is rethrown by the next submit() or finish().
+    class FrameExporter
+    {
+      public:
+        // t_directory must already exist, and zero threads means one per hardware thread
+        FrameExporter(
+            const std::filesystem::path & t_directory,
+            const FrameFormat t_format,
+            const std::size_t t_threadCount,
+            const std::size_t t_maxQueuedCount);
+
+        // waits for what is queued like finish() but ignores any errors
+        ~FrameExporter();
+
+        // prevent all copy and assignment
+        FrameExporter(const FrameExporter &) = delete;
+        FrameExporter(FrameExporter &&)      = delete;
+        //
+        FrameExporter & operator=(const FrameExporter &) = delete;
+        FrameExporter & operator=(FrameExporter &&)      = delete;
+
+        // a frame already written, so its pixels can be reused without allocating, or an empty
+        // one if there are none to spare yet
+        Frame spareFrame();
+
+        // only before finish()
+        void submit(Frame && t_frame);
+
+        // returns once every frame submitted is on disk
+        void finish();
+
+        std::size_t writtenCount() const;
+
+        // how many times submit() had to wait for the workers to make room
+        std::size_t stallCount() const;
+
+      private:
+        struct Job
+        {
+            std::size_t index{ 0 }; // in the order submitted
+            Frame frame;
+        };
+
+        void workerLoop();
+        void stopWorkers();
+
+        void writePng(const Frame & t_frame) const;
+        void writeY4m(const Job & t_job);
+
+        // t_frame as the Y, Cb and Cr planes of one Y4M frame, full range BT.601
+        static std::vector<std::uint8_t> encodeY4m(const Frame & t_frame);
+
+      private:
+        std::filesystem::path m_directory;
+        FrameFormat m_format;
+        std::size_t m_maxQueuedCount;
+        mutable std::mutex m_mutex;
+        std::condition_variable m_queueCondition; // a job was queued, or it is time to stop
+        std::condition_variable m_spaceCondition; // a job was taken, or a worker failed
+        std::deque<Job> m_queue;
+        std::vector<Frame> m_spareFrames;
+        std::size_t m_submittedCount;
+        std::size_t m_writtenCount;
+        std::size_t m_stallCount;
+        bool m_isStopping;
+        std::exception_ptr m_exceptionPtr; // the first one any worker threw
+
+        // so Y4m frames are written one at a time and in order
+        std::mutex m_y4mMutex;
+        std::condition_variable m_y4mCondition;
+        std::size_t m_y4mNextIndex;
+        std::ofstream m_y4mFile; // opened by the first frame, which sets the size of the rest
+        sf::Vector2u m_y4mSize;
+
+        std::vector<std::thread> m_workers; // last, so they start after everything else is made
+    };
+
+} // namespace gameoflife
+
+#endif // FRAME_EXPORTER_HPP_INCLUDED
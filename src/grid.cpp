@@ -5,17 +5,37 @@
 
 #include "sfml-util.hpp"
 
+#include <algorithm>
 #include <cmath>
+#include <cstring>
 
 namespace gameoflife
 {
 
+    namespace
+    {
+        // any fewer and waking up the other threads costs more than it saves
+        constexpr std::size_t min_cells_per_band{ 256 * 1024 };
+
+        // on screen, in pixels, so even a board millions of cells wide can be seen whole
+        constexpr float min_cell_size{ 1.0f / 4096.0f };
+        constexpr float max_cell_size{ 512.0f };
+    } // namespace
+
     Grid::Grid()
-        : m_cellSize{}
-        , m_gridRegion{}
-        , m_grid{}
-        , m_lineVerts{}
-        , m_backgroundRectangle{}
+        : m_screenRegion{}
+        , m_boardSize{}
+        , m_cellSize{ min_cell_size }
+        , m_viewOrigin{}
+        , m_cells{}
+        , m_nextCells{}
+        , m_rule{ conway_rule }
+        , m_isToroidal{ false }
+        , m_rowKernel{ nullptr }
+        , m_cellShaderPtr{}
+        , m_threadPoolPtr{}
+        , m_enginePtr{}
+        , m_isEngineLoaded{ false }
     {}
 
     void Grid::setup(const Config & t_config)
@@ -23,119 +43,144 @@ namespace gameoflife
         // setup/size the grid vectors
         reset(t_config);
 
-        // establish cell size
+        // only cells inside this region are drawn, which leaves a pad around the screen edge
         const sf::Vector2f screenSize{ t_config.video_mode.size };
         const sf::Vector2f padSize{ t_config.screen_edge_pad_ratio * screenSize };
-        const sf::FloatRect gridRegionRaw{ padSize, { screenSize - (padSize * 2.0f) } };
-
-        const sf::Vector2f cellSizeRaw{ gridRegionRaw.size / sf::Vector2f{ t_config.cell_counts } };
+        m_screenRegion = { padSize, { screenSize - (padSize * 2.0f) } };
+        m_boardSize    = t_config.cell_counts;
+        fitView();
 
-        const float cellDimm{ std::floor(std::min(cellSizeRaw.x, cellSizeRaw.y)) };
-        m_cellSize.x = cellDimm;
-        m_cellSize.y = cellDimm;
-
-        // establish where on screen the grid is (center it)
-        m_gridRegion.size       = { m_cellSize * sf::Vector2f{ t_config.cell_counts } };
-        m_gridRegion.position   = { (screenSize * 0.5f) - (m_gridRegion.size * 0.5f) };
-        m_gridRegion.position.x = std::floor(m_gridRegion.position.x);
-        m_gridRegion.position.y = std::floor(m_gridRegion.position.y);
-
-        // setup the grid background color
-        m_backgroundRectangle.setFillColor(t_config.grid_color_off);
-        m_backgroundRectangle.setSize(m_gridRegion.size);
-        m_backgroundRectangle.setPosition(m_gridRegion.position);
+        // the background, grid lines and cells are all drawn by this one shader
+        m_cellShaderPtr = std::make_unique<CellShader>();
+    }
 
-        // setup the grid cell lines
-        for (int x{ 0 }; x <= static_cast<int>(t_config.cell_counts.x); ++x)
+    void Grid::draw(
+        const Config & t_config,
+        const CellBuffer & t_cells,
+        const DensityPyramid & t_density,
+        sf::RenderTarget & t_target,
+        const sf::RenderStates & t_states) const
+    {
+        if ((m_cellSize >= 1.0f) || (t_density.levelCount() == 0))
         {
-            const float horizPos{ m_gridRegion.position.x +
-                                  (static_cast<float>(x) * m_cellSize.x) };
-
-            m_lineVerts.emplace_back(
-                sf::Vector2f{ horizPos, m_gridRegion.position.y }, t_config.grid_color_outline);
+            m_cellShaderPtr->draw(
+                t_config,
+                t_cells,
+                visibleRect(m_cellSize, t_cells.width(), t_cells.height()),
+                m_viewOrigin,
+                m_cellSize,
+                t_target,
+                t_states);
 
-            m_lineVerts.emplace_back(
-                sf::Vector2f{ horizPos, util::bottom(m_gridRegion) }, t_config.grid_color_outline);
+            return;
         }
 
-        for (int y{ 0 }; y <= static_cast<int>(t_config.cell_counts.y); ++y)
-        {
-            const float vertPos{ m_gridRegion.position.y + (static_cast<float>(y) * m_cellSize.y) };
-
-            m_lineVerts.emplace_back(
-                sf::Vector2f{ m_gridRegion.position.x, vertPos }, t_config.grid_color_outline);
-
-            m_lineVerts.emplace_back(
-                sf::Vector2f{ util::right(m_gridRegion), vertPos }, t_config.grid_color_outline);
-        }
+        // the smallest blocks that are still at least a pixel each
+        const auto levelIndex{ static_cast<std::size_t>(std::ceil(-std::log2(m_cellSize))) };
+        const std::size_t levelNumber{ std::clamp(
+            levelIndex, std::size_t{ 1 }, t_density.levelCount()) };
+
+        const DensityLevel & level{ t_density.level(levelNumber) };
+        const float blockSize{ std::ldexp(m_cellSize, static_cast<int>(levelNumber)) };
+
+        m_cellShaderPtr->drawDensity(
+            t_config,
+            level,
+            visibleRect(blockSize, level.width, level.height),
+            m_viewOrigin,
+            blockSize,
+            t_target,
+            t_states);
     }
 
-    void Grid::draw(
-        const Config & t_config,
-        sf::RenderTarget & t_target,
-        const sf::RenderStates & t_states) const
+    CellRect_t Grid::visibleRect(
+        const float t_unitSize, const std::size_t t_width, const std::size_t t_height) const
     {
-        t_target.draw(m_backgroundRectangle, t_states);
-        t_target.draw(&m_lineVerts[0], m_lineVerts.size(), sf::PrimitiveType::Lines);
+        const sf::Vector2f first{ (m_screenRegion.position - m_viewOrigin) / t_unitSize };
+        const sf::Vector2f last{ ((m_screenRegion.position + m_screenRegion.size) - m_viewOrigin) /
+                                 t_unitSize };
+
+        const auto clampToBoard{ [](const float t_unit, const std::size_t t_count) {
+            return static_cast<std::size_t>(
+                std::clamp(t_unit, 0.0f, static_cast<float>(t_count)));
+        } };
 
-        sf::RectangleShape rectangle;
-        rectangle.setFillColor(t_config.grid_color_on);
-        rectangle.setOutlineColor(t_config.grid_color_outline);
-        rectangle.setOutlineThickness(t_config.grid_line_thickness);
-        rectangle.setSize(m_cellSize);
+        const std::size_t beginX{ clampToBoard(std::floor(first.x), t_width) };
+        const std::size_t beginY{ clampToBoard(std::floor(first.y), t_height) };
+        const std::size_t endX{ clampToBoard(std::ceil(last.x), t_width) };
+        const std::size_t endY{ clampToBoard(std::ceil(last.y), t_height) };
 
-        for (int y{ 0 }; y < static_cast<int>(t_config.cell_counts.y); ++y)
+        if ((beginX >= endX) || (beginY >= endY))
         {
-            for (int x{ 0 }; x < static_cast<int>(t_config.cell_counts.x); ++x)
-            {
-                if (getCellValue({ x, y }) != 0)
-                {
-                    rectangle.setPosition(gridPositionToScreenPosition({ x, y }));
-                    t_target.draw(rectangle, t_states);
-                }
-            }
+            return {};
         }
+
+        return { { beginX, beginY }, { (endX - beginX), (endY - beginY) } };
     }
 
     const sf::Vector2f Grid::gridPositionToScreenPosition(const GridPos_t & t_position) const
     {
-        return (m_gridRegion.position + (sf::Vector2f{ t_position } * m_cellSize));
+        return (m_viewOrigin + (sf::Vector2f{ t_position } * m_cellSize));
     }
 
     const GridPos_t Grid::screenPositionToGridPosition(const sf::Vector2f & t_position) const
     {
-        sf::FloatRect screenRegion;
-        screenRegion.size = m_cellSize;
+        const sf::Vector2f cellPosition{ (t_position - m_viewOrigin) / m_cellSize };
+        const GridPos_t position{ static_cast<int>(std::floor(cellPosition.x)),
+                                  static_cast<int>(std::floor(cellPosition.y)) };
 
-        for (int y{ 0 }; y < static_cast<int>(m_grid.size()); ++y)
+        if ((position.x < 0) || (position.y < 0) ||
+            (position.x >= static_cast<int>(m_boardSize.x)) ||
+            (position.y >= static_cast<int>(m_boardSize.y)))
         {
-            for (int x{ 0 }; x < static_cast<int>(m_grid.front().size()); ++x)
-            {
-                screenRegion.position = gridPositionToScreenPosition({ x, y });
-                if (screenRegion.contains(t_position))
-                {
-                    return { x, y };
-                }
-            }
+            return { -1, -1 };
         }
 
-        return { -1, -1 };
+        return position;
+    }
+
+    void Grid::fitView()
+    {
+        const sf::Vector2f cellSizeRaw{ m_screenRegion.size / sf::Vector2f{ m_boardSize } };
+
+        // whole pixels per cell, or a whole number of cells per pixel for boards too big for that
+        const float cellSizeFit{ std::min(cellSizeRaw.x, cellSizeRaw.y) };
+        m_cellSize = std::clamp(
+            ((cellSizeFit >= 1.0f) ? std::floor(cellSizeFit)
+                                   : std::exp2(std::floor(std::log2(cellSizeFit)))),
+            min_cell_size,
+            max_cell_size);
+
+        // centered, on whole pixels
+        const sf::Vector2f boardSize{ sf::Vector2f{ m_boardSize } * m_cellSize };
+        const sf::Vector2f screenCenter{ m_screenRegion.position + (m_screenRegion.size * 0.5f) };
+        m_viewOrigin   = (screenCenter - (boardSize * 0.5f));
+        m_viewOrigin.x = std::floor(m_viewOrigin.x);
+        m_viewOrigin.y = std::floor(m_viewOrigin.y);
+    }
+
+    void Grid::zoomView(const float t_factor, const sf::Vector2f & t_screenPosition)
+    {
+        const sf::Vector2f cellPosition{ (t_screenPosition - m_viewOrigin) / m_cellSize };
+        m_cellSize   = std::clamp((m_cellSize * t_factor), min_cell_size, max_cell_size);
+        m_viewOrigin = (t_screenPosition - (cellPosition * m_cellSize));
     }
 
+    void Grid::panView(const sf::Vector2f & t_screenOffset) { m_viewOrigin += t_screenOffset; }
+
     bool Grid::isGridPositionValid(const GridPos_t & t_position) const
     {
         return (
             (t_position.x >= 0) && (t_position.y >= 0) &&
-            (t_position.y < static_cast<int>(m_grid.size())) &&
-            (t_position.x < static_cast<int>(m_grid.front().size())));
+            m_cells.isPositionValid(
+                static_cast<std::size_t>(t_position.x), static_cast<std::size_t>(t_position.y)));
     }
 
     CellType_t Grid::getCellValue(const GridPos_t & t_position) const
     {
         if (isGridPositionValid(t_position))
         {
-            return m_grid.at(static_cast<std::size_t>(t_position.y))
-                .at(static_cast<std::size_t>(t_position.x));
+            return m_cells.row(static_cast<std::size_t>(t_position.y))[t_position.x];
         }
         else
         {
@@ -150,11 +195,25 @@ namespace gameoflife
             return;
         }
 
-        m_grid.at(static_cast<std::size_t>(t_position.y))
-            .at(static_cast<std::size_t>(t_position.x)) = t_value;
+        // the kernels count neighbours by adding cells, so only ever store zero or one
+        m_cells.row(static_cast<std::size_t>(t_position.y))[t_position.x] =
+            ((t_value == 0) ? 0 : 1);
+
+        m_isEngineLoaded = false;
+    }
+
+    void Grid::loadCells(const CellBuffer & t_cells)
+    {
+        for (std::size_t y{ 0 }; y < m_cells.height(); ++y)
+        {
+            std::copy(t_cells.row(y), (t_cells.row(y) + m_cells.width()), m_cells.row(y));
+        }
+
+        m_isEngineLoaded = false;
     }
 
     /*
+        With the default rule (B3/S23, see Config::rule):
         Any live cell with fewer than two live neighbours dies, as if by underpopulation.
         Any live cell with two or three live neighbours lives on to the next generation.
         Any live cell with more than three live neighbours dies, as if by overpopulation.
@@ -162,52 +221,91 @@ namespace gameoflife
     */
     void Grid::processStep()
     {
-        std::vector<GridPos_t> positionsToFlip;
-        positionsToFlip.reserve(m_grid.size() * m_grid.front().size());
-
-        for (int y{ 0 }; y < static_cast<int>(m_grid.size()); ++y)
+        if (m_enginePtr)
         {
-            for (int x{ 0 }; x < static_cast<int>(m_grid.front().size()); ++x)
-            {
-                const std::size_t surroundingAliveCells{ getAliveCountAroundGridPosition(
-                    { x, y }) };
+            processSteps(1);
+            return;
+        }
 
-                if (getCellValue({ x, y }) == 0)
-                {
-                    if (surroundingAliveCells == 3)
-                    {
-                        positionsToFlip.emplace_back(x, y);
-                    }
-                }
-                else
-                {
-                    if ((surroundingAliveCells < 2) || (surroundingAliveCells > 3))
-                    {
-                        positionsToFlip.emplace_back(x, y);
-                    }
-                }
-            }
+        // once per step instead of wrapping every neighbour inside the kernels
+        if (m_isToroidal)
+        {
+            m_cells.wrapHalo();
         }
 
-        for (const GridPos_t & position : positionsToFlip)
+        // rows only read m_cells and only write their own row of m_nextCells, so any split
+        // into bands gives exactly the same result as doing them all on this thread
+        const std::size_t minRowsPerBand{ std::max(
+            std::size_t{ 1 }, (min_cells_per_band / std::max(std::size_t{ 1 }, m_cells.width()))) };
+
+        m_threadPoolPtr->forEachBand(
+            m_cells.height(),
+            minRowsPerBand,
+            [this](const std::size_t t_beginY, const std::size_t t_endY) {
+                processRows(t_beginY, t_endY);
+            });
+
+        // every cell of m_nextCells was just written and its halo is never written, so after
+        // this swap m_nextCells is ready to be overwritten by the next step
+        m_cells.swap(m_nextCells);
+    }
+
+    void Grid::processSteps(const std::size_t t_count)
+    {
+        if (!m_enginePtr)
         {
-            if (getCellValue(position) == 0)
+            for (std::size_t count{ 0 }; count < t_count; ++count)
             {
-                setCellValue(position, 1);
-            }
-            else
-            {
-                setCellValue(position, 0);
+                processStep();
             }
+
+            return;
+        }
+
+        if (!m_isEngineLoaded)
+        {
+            m_enginePtr->load(m_cells);
+            m_isEngineLoaded = true;
+        }
+
+        // some engines (HashLife) can do many steps much faster than one at a time
+        m_enginePtr->processSteps(t_count);
+        m_enginePtr->store(m_cells);
+    }
+
+    void Grid::processRows(const std::size_t t_beginY, const std::size_t t_endY)
+    {
+        const std::size_t stride{ m_cells.stride() };
+
+        for (std::size_t y{ t_beginY }; y < t_endY; ++y)
+        {
+            // the halo means every neighbour can be read without checking the edges
+            const CellType_t * const middle{ m_cells.row(y) };
+            m_rowKernel(
+                (middle - stride),
+                middle,
+                (middle + stride),
+                m_nextCells.row(y),
+                m_cells.width(),
+                m_rule);
         }
     }
 
     void Grid::reset(const Config & t_config)
     {
-        m_grid.clear();
+        m_cells.resize(t_config.cell_counts.x, t_config.cell_counts.y);
+        m_nextCells.resize(t_config.cell_counts.x, t_config.cell_counts.y);
 
-        m_grid.resize(
-            t_config.cell_counts.y, std::vector<unsigned char>(t_config.cell_counts.x, 0));
+        if (!m_threadPoolPtr)
+        {
+            m_threadPoolPtr = std::make_unique<ThreadPool>(t_config.thread_count);
+        }
+
+        m_rule           = parseRule(t_config.rule);
+        m_isToroidal     = t_config.is_toroidal;
+        m_rowKernel      = selectRowKernel(t_config.max_simd_level, m_rule);
+        m_enginePtr      = makeEngine(t_config, *m_threadPoolPtr);
+        m_isEngineLoaded = false;
     }
 
     std::size_t Grid::getAliveCountAroundGridPosition(const GridPos_t & t_position) const
@@ -218,17 +316,21 @@ namespace gameoflife
         {
             for (int x{ t_position.x - 1 }; x <= (t_position.x + 1); ++x)
             {
-                if (!isGridPositionValid({ x, y }))
+                if ((t_position.x == x) && (t_position.y == y))
                 {
                     continue;
                 }
 
-                if ((t_position.x == x) && (t_position.y == y))
+                GridPos_t position{ x, y };
+                if (m_isToroidal && !isGridPositionValid(position))
                 {
-                    continue;
+                    const int width{ static_cast<int>(m_cells.width()) };
+                    const int height{ static_cast<int>(m_cells.height()) };
+                    position.x = (((x % width) + width) % width);
+                    position.y = (((y % height) + height) % height);
                 }
 
-                if (m_grid.at(static_cast<std::size_t>(y)).at(static_cast<std::size_t>(x)) != 0)
+                if (getCellValue(position) != 0)
                 {
                     ++count;
                 }
@@ -238,4 +340,60 @@ namespace gameoflife
         return count;
     }
 
+    std::size_t Grid::countAliveCells() const
+    {
+        std::size_t count{ 0 };
+
+        for (std::size_t y{ 0 }; y < m_cells.height(); ++y)
+        {
+            const CellType_t * const row{ m_cells.row(y) };
+            count += static_cast<std::size_t>(std::count(row, (row + m_cells.width()), 1));
+        }
+
+        return count;
+    }
+
+    std::uint64_t Grid::hashCells() const
+    {
+        // FNV-1a, but eight cells at a time since the rows are long
+        std::uint64_t hash{ 14695981039346656037ull };
+
+        for (std::size_t y{ 0 }; y < m_cells.height(); ++y)
+        {
+            const CellType_t * const row{ m_cells.row(y) };
+
+            std::size_t x{ 0 };
+            for (; (x + sizeof(std::uint64_t)) <= m_cells.width(); x += sizeof(std::uint64_t))
+            {
+                std::uint64_t eightCells;
+                std::memcpy(&eightCells, (row + x), sizeof(eightCells));
+                hash = ((hash ^ eightCells) * 1099511628211ull);
+            }
+
+            for (; x < m_cells.width(); ++x)
+            {
+                hash = ((hash ^ row[x]) * 1099511628211ull);
+            }
+        }
+
+        return hash;
+    }
+
+    std::string_view Grid::engineName() const
+    {
+        return (m_enginePtr ? m_enginePtr->name() : toString(EngineType::Reference));
+    }
+
+    std::size_t Grid::engineByteCount() const
+    {
+        if (m_enginePtr)
+        {
+            return m_enginePtr->byteCount();
+        }
+        else
+        {
+            return (m_cells.byteCount() + m_nextCells.byteCount());
+        }
+    }
+
 } // namespace gameoflife
@@ -3,23 +3,28 @@
 //
 // grid.hpp
 //
+#include "byte-kernel.hpp"
+#include "cell-buffer.hpp"
+#include "cell-shader.hpp"
 #include "config.hpp"
+#include "density-pyramid.hpp"
+#include "engine.hpp"
+#include "rule.hpp"
+#include "thread-pool.hpp"
 
-#include <SFML/Graphics/Drawable.hpp>
-#include <SFML/Graphics/RectangleShape.hpp>
+#include <SFML/Graphics/Rect.hpp>
 #include <SFML/Graphics/RenderStates.hpp>
 #include <SFML/Graphics/RenderTarget.hpp>
-#include <SFML/Graphics/Vertex.hpp>
 
+#include <cstdint>
+#include <memory>
 #include <optional>
-#include <vector>
+#include <string_view>
 
 namespace gameoflife
 {
 
-    using CellType_t = unsigned char;
-    using GridPos_t  = sf::Vector2i;
-    using Grid_t     = std::vector<std::vector<CellType_t>>;
+    using GridPos_t = sf::Vector2i;
 
     //
 
@@ -30,30 +35,83 @@ namespace gameoflife
 
         void setup(const Config & t_config);
 
+        // t_cells instead of this Grid's own, so a copy can be drawn while this one steps, and
+        // only after setup().  Only the cells in view are drawn (and uploaded), so the cost
+        // follows the size of the screen and not the size of the board.  Zoomed out past one
+        // cell per pixel, t_density (of t_cells) is drawn instead, from the level with about
+        // one block per pixel.
         void draw(
             const Config & t_config,
+            const CellBuffer & t_cells,
+            const DensityPyramid & t_density,
             sf::RenderTarget & t_target,
             const sf::RenderStates & t_states) const;
 
         void processStep();
+        void processSteps(const std::size_t t_count);
         void reset(const Config & t_config);
 
         CellType_t getCellValue(const GridPos_t & t_position) const;
         void setCellValue(const GridPos_t & t_position, const CellType_t t_value);
 
+        // every cell at once, so t_cells must be the size reset() was given
+        void loadCells(const CellBuffer & t_cells);
+
+        // These and the view functions below only use what setup() and the view set, never the
+        // cells, so they are safe to call while another thread steps this Grid.  Positions not
+        // over the board become { -1, -1 }.
         const sf::Vector2f gridPositionToScreenPosition(const GridPos_t & t_position) const;
         const GridPos_t screenPositionToGridPosition(const sf::Vector2f & t_position) const;
 
+        // the whole board in the middle of the screen
+        void fitView();
+
+        // keeps the cell under t_screenPosition where it is
+        void zoomView(const float t_factor, const sf::Vector2f & t_screenPosition);
+
+        void panView(const sf::Vector2f & t_screenOffset);
+
         bool isGridPositionValid(const GridPos_t & t_position) const;
 
         std::size_t getAliveCountAroundGridPosition(const GridPos_t & t_position) const;
 
+        // of the whole board, so cells an unbounded engine has off the board aren't counted
+        std::size_t countAliveCells() const;
+
+        // the board as of the last step, already stored back from any engine
+        const CellBuffer & cells() const { return m_cells; }
+
+        // changes whenever any cell changes, but is only meant for comparing boards of one size
+        std::uint64_t hashCells() const;
+
+        std::string_view engineName() const;
+
+        // of whatever is stepping the board, so both CellBuffers if there is no engine
+        std::size_t engineByteCount() const;
+
+      private:
+        // the cells, or blocks of cells, of t_unitSize on screen that are at least partly inside
+        // the screen region, and empty if there are none
+        CellRect_t visibleRect(
+            const float t_unitSize, const std::size_t t_width, const std::size_t t_height) const;
+
+        // [t_beginY, t_endY) of m_cells into the same rows of m_nextCells
+        void processRows(const std::size_t t_beginY, const std::size_t t_endY);
+
       private:
-        sf::Vector2f m_cellSize;
-        sf::FloatRect m_gridRegion;
-        Grid_t m_grid;
-        std::vector<sf::Vertex> m_lineVerts;
-        sf::RectangleShape m_backgroundRectangle;
+        sf::FloatRect m_screenRegion; // where on screen the board can be drawn
+        sf::Vector2u m_boardSize;     // what setup() was given, so the view never reads m_cells
+        float m_cellSize;             // on screen, so this is the zoom
+        sf::Vector2f m_viewOrigin;    // where the top-left of cell (0,0) is on screen
+        CellBuffer m_cells;
+        CellBuffer m_nextCells;
+        Rule m_rule;
+        bool m_isToroidal;
+        RowKernel_t m_rowKernel;
+        std::unique_ptr<CellShader> m_cellShaderPtr; // only setup() makes one, see draw()
+        std::unique_ptr<ThreadPool> m_threadPoolPtr;
+        std::unique_ptr<IEngine> m_enginePtr;
+        bool m_isEngineLoaded;
     };
 
 } // namespace gameoflife
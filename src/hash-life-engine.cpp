@@ -0,0 +1,537 @@
+//
+// hash-life-engine.cpp
+//
+#include "hash-life-engine.hpp"
+
+#include <algorithm>
+#include <functional>
+
+namespace gameoflife
+{
+
+    namespace
+    {
+        // the node itself plus a rough guess at what std::unordered_map spends per entry
+        constexpr std::size_t bytes_per_node{ 96 };
+
+        // 8x8 is the smallest root, so the top level successor() never reaches a leaf
+        constexpr std::uint8_t min_root_level{ 3 };
+    } // namespace
+
+    std::size_t HashLifeEngine::ChildrenHash::operator()(const Children_t & t_children) const
+    {
+        std::uint64_t hash{ 0 };
+        for (const Index_t child : t_children)
+        {
+            hash = ((hash + child) * 0x9E3779B97F4A7C15ull);
+        }
+
+        return std::hash<std::uint64_t>{}(hash ^ (hash >> 32));
+    }
+
+    HashLifeEngine::HashLifeEngine(const Rule & t_rule, const std::size_t t_memoryLimitBytes)
+        : m_rule{ t_rule }
+        , m_nodeLimit{ std::max(std::size_t{ 1024 }, (t_memoryLimitBytes / bytes_per_node)) }
+        , m_nodes{}
+        , m_table{}
+        , m_emptyNodes{}
+        , m_root{ dead_leaf }
+        , m_rootLeft{ 0 }
+        , m_rootTop{ 0 }
+        , m_isLimited{ false }
+        , m_isOverLimit{ false }
+    {
+        clearNodes();
+    }
+
+    void HashLifeEngine::clearNodes()
+    {
+        m_nodes.clear();
+        m_table.clear();
+        m_emptyNodes.clear();
+
+        // the two leaves are never in m_table and never collected
+        m_nodes.push_back({ {}, no_result, 0, 0, 0, false });
+        m_nodes.push_back({ {}, no_result, 1, 0, 0, false });
+        m_emptyNodes.push_back(dead_leaf);
+
+        m_root     = emptyNode(min_root_level);
+        m_rootLeft = 0;
+        m_rootTop  = 0;
+    }
+
+    HashLifeEngine::Index_t HashLifeEngine::join(
+        const Index_t t_nw, const Index_t t_ne, const Index_t t_sw, const Index_t t_se)
+    {
+        const Children_t children{ t_nw, t_ne, t_sw, t_se };
+
+        const auto iter{ m_table.find(children) };
+        if (iter != std::end(m_table))
+        {
+            return iter->second;
+        }
+
+        Node node{};
+        node.children       = children;
+        node.result         = no_result;
+        node.level          = static_cast<std::uint8_t>(m_nodes[t_nw].level + 1);
+        node.resultStepLog2 = 0;
+        node.isMarked       = false;
+
+        node.population = (m_nodes[t_nw].population + m_nodes[t_ne].population +
+                           m_nodes[t_sw].population + m_nodes[t_se].population);
+
+        const auto index{ static_cast<Index_t>(m_nodes.size()) };
+        m_nodes.push_back(node);
+        m_table.emplace(children, index);
+        return index;
+    }
+
+    HashLifeEngine::Index_t HashLifeEngine::emptyNode(const std::uint8_t t_level)
+    {
+        while (m_emptyNodes.size() <= t_level)
+        {
+            const Index_t smaller{ m_emptyNodes.back() };
+            m_emptyNodes.push_back(join(smaller, smaller, smaller, smaller));
+        }
+
+        return m_emptyNodes[t_level];
+    }
+
+    // the center 2x2 of a 4x4 after one generation
+    HashLifeEngine::Index_t HashLifeEngine::successorOfLevelTwo(const Index_t t_node)
+    {
+        // bit (y * 4 + x) is the cell at (x,y)
+        unsigned cells{ 0 };
+        for (unsigned quadrant{ 0 }; quadrant < 4; ++quadrant)
+        {
+            const Children_t & leaves{ m_nodes[m_nodes[t_node].children[quadrant]].children };
+
+            for (unsigned leaf{ 0 }; leaf < 4; ++leaf)
+            {
+                if (leaves[leaf] == alive_leaf)
+                {
+                    const unsigned x{ ((quadrant % 2) * 2) + (leaf % 2) };
+                    const unsigned y{ ((quadrant / 2) * 2) + (leaf / 2) };
+                    cells |= (1u << ((y * 4) + x));
+                }
+            }
+        }
+
+        const auto nextLeaf = [&](const unsigned t_x, const unsigned t_y) {
+            unsigned count{ 0 };
+            for (unsigned y{ t_y - 1 }; y <= (t_y + 1); ++y)
+            {
+                for (unsigned x{ t_x - 1 }; x <= (t_x + 1); ++x)
+                {
+                    if (((x != t_x) || (y != t_y)) && ((cells >> ((y * 4) + x)) & 1))
+                    {
+                        ++count;
+                    }
+                }
+            }
+
+            const bool isAlive{ ((cells >> ((t_y * 4) + t_x)) & 1) != 0 };
+            return (m_rule.isAliveNext(isAlive, count) ? alive_leaf : dead_leaf);
+        };
+
+        return join(nextLeaf(1, 1), nextLeaf(2, 1), nextLeaf(1, 2), nextLeaf(2, 2));
+    }
+
+    // The center half of t_node after 2^t_stepLog2 generations, or after 2^(level-2) if that is
+    // smaller.  The node is split into nine overlapping half size squares whose centers are
+    // advanced.  For a full 2^(level-2) step those nine are joined into four and advanced again,
+    // otherwise the four quarters of the answer are just pieced together from the nine.
+    HashLifeEngine::Index_t
+        HashLifeEngine::successor(const Index_t t_node, const std::uint8_t t_stepLog2)
+    {
+        const std::uint8_t level{ m_nodes[t_node].level };
+
+        if (0 == m_nodes[t_node].population)
+        {
+            return emptyNode(static_cast<std::uint8_t>(level - 1));
+        }
+
+        const std::uint8_t stepLog2{ std::min(t_stepLog2, static_cast<std::uint8_t>(level - 2)) };
+
+        if ((m_nodes[t_node].result != no_result) &&
+            (m_nodes[t_node].resultStepLog2 == stepLog2))
+        {
+            return m_nodes[t_node].result;
+        }
+
+        // Past the limit the answer no longer matters, since tryAdvance() throws it away, so
+        // return anything that makes no new nodes and let every caller unwind quickly.
+        if (m_isLimited && (nodeCount() > m_nodeLimit))
+        {
+            m_isOverLimit = true;
+        }
+
+        if (m_isOverLimit)
+        {
+            return emptyNode(static_cast<std::uint8_t>(level - 1));
+        }
+
+        Index_t result{ no_result };
+
+        if (2 == level)
+        {
+            result = successorOfLevelTwo(t_node);
+        }
+        else
+        {
+            // copies because join() can grow m_nodes and invalidate references into it
+            const Children_t quads{ m_nodes[t_node].children };
+            const Children_t nw{ m_nodes[quads[0]].children };
+            const Children_t ne{ m_nodes[quads[1]].children };
+            const Children_t sw{ m_nodes[quads[2]].children };
+            const Children_t se{ m_nodes[quads[3]].children };
+
+            // the nine overlapping squares, by row then column
+            const Index_t n00{ quads[0] };
+            const Index_t n01{ join(nw[1], ne[0], nw[3], ne[2]) };
+            const Index_t n02{ quads[1] };
+            const Index_t n10{ join(nw[2], nw[3], sw[0], sw[1]) };
+            const Index_t n11{ join(nw[3], ne[2], sw[1], se[0]) };
+            const Index_t n12{ join(ne[2], ne[3], se[0], se[1]) };
+            const Index_t n20{ quads[2] };
+            const Index_t n21{ join(sw[1], se[0], sw[3], se[2]) };
+            const Index_t n22{ quads[3] };
+
+            const Index_t c00{ successor(n00, stepLog2) };
+            const Index_t c01{ successor(n01, stepLog2) };
+            const Index_t c02{ successor(n02, stepLog2) };
+            const Index_t c10{ successor(n10, stepLog2) };
+            const Index_t c11{ successor(n11, stepLog2) };
+            const Index_t c12{ successor(n12, stepLog2) };
+            const Index_t c20{ successor(n20, stepLog2) };
+            const Index_t c21{ successor(n21, stepLog2) };
+            const Index_t c22{ successor(n22, stepLog2) };
+
+            if (stepLog2 == (level - 2))
+            {
+                const Index_t resultNw{ successor(join(c00, c01, c10, c11), stepLog2) };
+                const Index_t resultNe{ successor(join(c01, c02, c11, c12), stepLog2) };
+                const Index_t resultSw{ successor(join(c10, c11, c20, c21), stepLog2) };
+                const Index_t resultSe{ successor(join(c11, c12, c21, c22), stepLog2) };
+                result = join(resultNw, resultNe, resultSw, resultSe);
+            }
+            else
+            {
+                const auto quad = [this](const Index_t t_index, const std::size_t t_quadrant) {
+                    return m_nodes[t_index].children[t_quadrant];
+                };
+
+                const Index_t resultNw{ join(
+                    quad(c00, 3), quad(c01, 2), quad(c10, 1), quad(c11, 0)) };
+
+                const Index_t resultNe{ join(
+                    quad(c01, 3), quad(c02, 2), quad(c11, 1), quad(c12, 0)) };
+
+                const Index_t resultSw{ join(
+                    quad(c10, 3), quad(c11, 2), quad(c20, 1), quad(c21, 0)) };
+
+                const Index_t resultSe{ join(
+                    quad(c11, 3), quad(c12, 2), quad(c21, 1), quad(c22, 0)) };
+
+                result = join(resultNw, resultNe, resultSw, resultSe);
+            }
+        }
+
+        // a result pieced together from ones that gave up would be wrong
+        if (!m_isOverLimit)
+        {
+            m_nodes[t_node].result         = result;
+            m_nodes[t_node].resultStepLog2 = stepLog2;
+        }
+
+        return result;
+    }
+
+    // grows the universe by half in every direction, keeping the old root at the center
+    void HashLifeEngine::expandRoot()
+    {
+        const Children_t quads{ m_nodes[m_root].children };
+        const std::uint8_t level{ m_nodes[m_root].level };
+        const Index_t empty{ emptyNode(static_cast<std::uint8_t>(level - 1)) };
+
+        const Index_t nw{ join(empty, empty, empty, quads[0]) };
+        const Index_t ne{ join(empty, empty, quads[1], empty) };
+        const Index_t sw{ join(empty, quads[2], empty, empty) };
+        const Index_t se{ join(quads[3], empty, empty, empty) };
+        m_root = join(nw, ne, sw, se);
+
+        const std::int64_t shift{ std::int64_t{ 1 } << (level - 1) };
+        m_rootLeft -= shift;
+        m_rootTop -= shift;
+    }
+
+    bool HashLifeEngine::isRootCenterHoldingEverything() const
+    {
+        const Children_t & quads{ m_nodes[m_root].children };
+
+        const std::uint64_t centerPopulation{
+            m_nodes[m_nodes[quads[0]].children[3]].population +
+            m_nodes[m_nodes[quads[1]].children[2]].population +
+            m_nodes[m_nodes[quads[2]].children[1]].population +
+            m_nodes[m_nodes[quads[3]].children[0]].population
+        };
+
+        return (centerPopulation == m_nodes[m_root].population);
+    }
+
+    void HashLifeEngine::advance(const std::uint8_t t_stepLog2)
+    {
+        if (tryAdvance(t_stepLog2, true))
+        {
+            return;
+        }
+
+        // what the failed try made is garbage now, and so are the results from before it
+        collectGarbage();
+
+        if (0 == t_stepLog2)
+        {
+            // there is nothing smaller to split into, so this one gets what it needs
+            tryAdvance(t_stepLog2, false);
+        }
+        else if (!tryAdvance(t_stepLog2, true))
+        {
+            collectGarbage();
+
+            const auto halfStepLog2{ static_cast<std::uint8_t>(t_stepLog2 - 1) };
+            advance(halfStepLog2);
+            advance(halfStepLog2);
+        }
+    }
+
+    bool HashLifeEngine::tryAdvance(const std::uint8_t t_stepLog2, const bool t_isLimited)
+    {
+        const Index_t oldRoot{ m_root };
+        const std::int64_t oldRootLeft{ m_rootLeft };
+        const std::int64_t oldRootTop{ m_rootTop };
+
+        // Everything must fit in the center half with at least 2^t_stepLog2 of empty space
+        // around it, because that is as far as anything can grow in that many generations.
+        while ((m_nodes[m_root].level < (t_stepLog2 + 2)) || !isRootCenterHoldingEverything())
+        {
+            expandRoot();
+        }
+
+        expandRoot();
+
+        m_isLimited   = t_isLimited;
+        m_isOverLimit = false;
+        const Index_t result{ successor(m_root, t_stepLog2) };
+        m_isLimited = false;
+
+        // put back the smaller root too, or every failed try would leave it a level bigger
+        if (m_isOverLimit)
+        {
+            m_isOverLimit = false;
+            m_root        = oldRoot;
+            m_rootLeft    = oldRootLeft;
+            m_rootTop     = oldRootTop;
+            return false;
+        }
+
+        const std::int64_t shift{ std::int64_t{ 1 } << (m_nodes[m_root].level - 2) };
+        m_root = result;
+        m_rootLeft += shift;
+        m_rootTop += shift;
+        return true;
+    }
+
+    void HashLifeEngine::processSteps(const std::size_t t_count)
+    {
+        for (std::uint8_t stepLog2{ 0 }; (t_count >> stepLog2) != 0; ++stepLog2)
+        {
+            if (0 == ((t_count >> stepLog2) & 1))
+            {
+                continue;
+            }
+
+            if (nodeCount() > m_nodeLimit)
+            {
+                collectGarbage();
+            }
+
+            if (0 == m_nodes[m_root].population)
+            {
+                return;
+            }
+
+            advance(stepLog2);
+        }
+    }
+
+    void HashLifeEngine::mark(const Index_t t_node)
+    {
+        Node & node{ m_nodes[t_node] };
+        if (node.isMarked)
+        {
+            return;
+        }
+
+        node.isMarked = true;
+
+        if (node.level > 0)
+        {
+            for (const Index_t child : node.children)
+            {
+                mark(child);
+            }
+        }
+    }
+
+    // Keeps only the universe itself and the empty squares, which also drops every remembered
+    // result since those could point at anything.  The nodes kept are moved down into a new
+    // vector and the table is built again, both only as big as what is kept, so the memory
+    // really is given back.
+    void HashLifeEngine::collectGarbage()
+    {
+        mark(m_root);
+
+        for (const Index_t empty : m_emptyNodes)
+        {
+            mark(empty);
+        }
+
+        // the two leaves always keep their indexes
+        std::vector<Index_t> newIndexes(m_nodes.size(), no_result);
+        Index_t keptCount{ 0 };
+        for (std::size_t index{ 0 }; index < m_nodes.size(); ++index)
+        {
+            if ((index <= alive_leaf) || m_nodes[index].isMarked)
+            {
+                newIndexes[index] = keptCount++;
+            }
+        }
+
+        std::vector<Node> nodes;
+        nodes.reserve(keptCount);
+
+        std::unordered_map<Children_t, Index_t, ChildrenHash> table;
+        table.reserve(keptCount);
+
+        for (std::size_t index{ 0 }; index < m_nodes.size(); ++index)
+        {
+            if (newIndexes[index] == no_result)
+            {
+                continue;
+            }
+
+            Node node{ m_nodes[index] };
+            node.isMarked = false;
+            node.result   = no_result;
+
+            if (node.level > 0)
+            {
+                for (Index_t & child : node.children)
+                {
+                    child = newIndexes[child];
+                }
+
+                table.emplace(node.children, newIndexes[index]);
+            }
+
+            nodes.push_back(node);
+        }
+
+        m_nodes.swap(nodes);
+        m_table.swap(table);
+
+        m_root = newIndexes[m_root];
+        for (Index_t & empty : m_emptyNodes)
+        {
+            empty = newIndexes[empty];
+        }
+    }
+
+    void HashLifeEngine::load(const CellBuffer & t_cells)
+    {
+        clearNodes();
+
+        std::uint8_t level{ min_root_level };
+        while ((std::size_t{ 1 } << level) < std::max(t_cells.width(), t_cells.height()))
+        {
+            ++level;
+        }
+
+        m_root = build(t_cells, 0, 0, level);
+    }
+
+    HashLifeEngine::Index_t HashLifeEngine::build(
+        const CellBuffer & t_cells,
+        const std::size_t t_left,
+        const std::size_t t_top,
+        const std::uint8_t t_level)
+    {
+        if ((t_left >= t_cells.width()) || (t_top >= t_cells.height()))
+        {
+            return emptyNode(t_level);
+        }
+
+        if (0 == t_level)
+        {
+            return ((t_cells.row(t_top)[t_left] == 0) ? dead_leaf : alive_leaf);
+        }
+
+        const std::uint8_t childLevel{ static_cast<std::uint8_t>(t_level - 1) };
+        const std::size_t half{ std::size_t{ 1 } << childLevel };
+
+        const Index_t nw{ build(t_cells, t_left, t_top, childLevel) };
+        const Index_t ne{ build(t_cells, (t_left + half), t_top, childLevel) };
+        const Index_t sw{ build(t_cells, t_left, (t_top + half), childLevel) };
+        const Index_t se{ build(t_cells, (t_left + half), (t_top + half), childLevel) };
+        return join(nw, ne, sw, se);
+    }
+
+    void HashLifeEngine::store(CellBuffer & t_cells) const
+    {
+        t_cells.clear();
+        write(m_root, m_rootLeft, m_rootTop, t_cells);
+    }
+
+    void HashLifeEngine::write(
+        const Index_t t_node,
+        const std::int64_t t_left,
+        const std::int64_t t_top,
+        CellBuffer & t_cells) const
+    {
+        const Node & node{ m_nodes[t_node] };
+        const std::int64_t size{ std::int64_t{ 1 } << node.level };
+
+        if ((0 == node.population) || ((t_left + size) <= 0) || ((t_top + size) <= 0) ||
+            (t_left >= static_cast<std::int64_t>(t_cells.width())) ||
+            (t_top >= static_cast<std::int64_t>(t_cells.height())))
+        {
+            return;
+        }
+
+        if (0 == node.level)
+        {
+            t_cells.row(static_cast<std::size_t>(t_top))[t_left] = 1;
+            return;
+        }
+
+        const std::int64_t half{ size / 2 };
+        write(node.children[0], t_left, t_top, t_cells);
+        write(node.children[1], (t_left + half), t_top, t_cells);
+        write(node.children[2], t_left, (t_top + half), t_cells);
+        write(node.children[3], (t_left + half), (t_top + half), t_cells);
+    }
+
+    std::size_t HashLifeEngine::byteCount() const
+    {
+        // a guess at each map node, since the standard doesn't say how big they are
+        const std::size_t mapNodeBytes{ sizeof(Children_t) + sizeof(Index_t) +
+                                        (2 * sizeof(void *)) };
+
+        return (
+            (m_nodes.capacity() * sizeof(Node)) + (m_table.size() * mapNodeBytes) +
+            (m_table.bucket_count() * sizeof(void *)) +
+            (m_emptyNodes.capacity() * sizeof(Index_t)));
+    }
+
+} // namespace gameoflife
@@ -0,0 +1,122 @@
+#ifndef HASH_LIFE_ENGINE_HPP_INCLUDED
+#define HASH_LIFE_ENGINE_HPP_INCLUDED
+//
+// hash-life-engine.hpp
+//
+#include "engine.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace gameoflife
+{
+
+    // Gosper's HashLife.  The universe is a quadtree where identical squares are the same node,
+    // and every node remembers the center half of itself some power of two generations later.
+    // So repetitive patterns (guns, breeders, spacefillers) can be advanced by 2^k generations
+    // with far less than 2^k work.
+    //
+    // The universe is unbounded.  load() puts the board's top-left at (0,0), and store() copies
+    // back only what is inside the board.  Nothing is ever lost off the edges, so unlike the
+    // other engines, patterns that reach the edge of the board carry on out of sight.
+    //
+    // Any rule works except ones where empty space comes alive (B0), since the empty squares
+    // surrounding everything have to stay empty.
+    //
+    // The memory limit is checked as nodes are made, even part way through a jump.  A jump that
+    // goes past it is abandoned, everything not reachable from the universe is thrown away and
+    // the memory given back, and the jump is tried again, then split in two half as long if it
+    // still doesn't fit.  A single generation gets whatever it needs, so a universe too big for
+    // the limit on its own still steps, only slowly.
+    class HashLifeEngine : public IEngine
+    {
+      public:
+        HashLifeEngine(const Rule & t_rule, const std::size_t t_memoryLimitBytes);
+        virtual ~HashLifeEngine() override = default;
+
+        std::string_view name() const override { return "hashlife"; }
+
+        void load(const CellBuffer & t_cells) override;
+        void store(CellBuffer & t_cells) const override;
+        std::size_t byteCount() const override;
+
+        void processStep() override { processSteps(1); }
+        void processSteps(const std::size_t t_count) override;
+
+        std::size_t nodeCount() const { return m_nodes.size(); }
+        std::uint64_t population() const { return m_nodes[m_root].population; }
+
+      private:
+        using Index_t = std::uint32_t;
+
+        // nw, ne, sw, se
+        using Children_t = std::array<Index_t, 4>;
+
+        struct Node
+        {
+            Children_t children;
+            Index_t result; // the center half after 2^resultStepLog2 generations
+            std::uint64_t population;
+            std::uint8_t level; // the square is 2^level on a side
+            std::uint8_t resultStepLog2;
+            bool isMarked;
+        };
+
+        struct ChildrenHash
+        {
+            std::size_t operator()(const Children_t & t_children) const;
+        };
+
+        static constexpr Index_t dead_leaf{ 0 };
+        static constexpr Index_t alive_leaf{ 1 };
+        static constexpr Index_t no_result{ ~Index_t{ 0 } };
+
+        void clearNodes();
+        Index_t
+            join(const Index_t t_nw, const Index_t t_ne, const Index_t t_sw, const Index_t t_se);
+        Index_t emptyNode(const std::uint8_t t_level);
+
+        Index_t successor(const Index_t t_node, const std::uint8_t t_stepLog2);
+        Index_t successorOfLevelTwo(const Index_t t_node);
+
+        void advance(const std::uint8_t t_stepLog2);
+
+        // returns false, with the universe as it was, if t_isLimited and the limit was reached
+        bool tryAdvance(const std::uint8_t t_stepLog2, const bool t_isLimited);
+        void expandRoot();
+        bool isRootCenterHoldingEverything() const;
+
+        void collectGarbage();
+        void mark(const Index_t t_node);
+
+        Index_t build(
+            const CellBuffer & t_cells,
+            const std::size_t t_left,
+            const std::size_t t_top,
+            const std::uint8_t t_level);
+
+        void write(
+            const Index_t t_node,
+            const std::int64_t t_left,
+            const std::int64_t t_top,
+            CellBuffer & t_cells) const;
+
+      private:
+        Rule m_rule;
+        std::size_t m_nodeLimit;
+        std::vector<Node> m_nodes;
+        std::unordered_map<Children_t, Index_t, ChildrenHash> m_table;
+        std::vector<Index_t> m_emptyNodes; // by level
+        Index_t m_root;
+        std::int64_t m_rootLeft;
+        std::int64_t m_rootTop;
+        bool m_isLimited;   // only while tryAdvance() runs
+        bool m_isOverLimit; // so every successor() still running gives up
+    };
+
+} // namespace gameoflife
+
+#endif // HASH_LIFE_ENGINE_HPP_INCLUDED
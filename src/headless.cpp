@@ -0,0 +1,176 @@
+//
+// headless.cpp
+//
+#include "headless.hpp"
+
+#include "frame-exporter.hpp"
+#include "grid.hpp"
+#include "offscreen-renderer.hpp"
+#include "patterns.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+
+namespace gameoflife
+{
+
+    namespace
+    {
+        void seedBoard(Grid & t_grid, const Config & t_config, const CommandLine & t_commandLine)
+        {
+            const sf::Vector2i centerPosition{ t_config.cell_counts / 2u };
+
+            // straight into the cells, since a list of every live cell of a big board would
+            // take gigabytes, and first so the patterns below land on top of it
+            if (t_commandLine.random_density > 0.0f)
+            {
+                CellBuffer soup;
+                soup.resize(t_config.cell_counts.x, t_config.cell_counts.y);
+                fillRandomCells(soup, t_commandLine.random_density, t_commandLine.random_seed);
+                t_grid.loadCells(soup);
+            }
+
+            if (!t_commandLine.pattern_name.empty())
+            {
+                const Pattern * const patternPtr{ findPresetPattern(t_commandLine.pattern_name) };
+                if (patternPtr == nullptr)
+                {
+                    throw std::runtime_error(
+                        "Unknown pattern \"" + t_commandLine.pattern_name + "\", try --help.");
+                }
+
+                placePattern(t_grid, *patternPtr, centerPosition);
+            }
+
+            if (!t_commandLine.pattern_path.empty())
+            {
+                placePattern(t_grid, loadPatternFile(t_commandLine.pattern_path), centerPosition);
+            }
+        }
+
+        // t_rendererPtr is null for one pixel per cell
+        void stepAndExport(
+            Grid & t_grid,
+            OffscreenRenderer * const t_rendererPtr,
+            const Config & t_config,
+            const CommandLine & t_commandLine)
+        {
+            const std::filesystem::path directory{ t_commandLine.export_directory };
+            std::filesystem::create_directories(directory);
+
+            FrameExporter exporter{ directory,
+                                    t_commandLine.export_format,
+                                    t_commandLine.export_thread_count,
+                                    t_commandLine.export_queue_size };
+
+            const auto exportFrame{ [&](const std::size_t t_generation) {
+                Frame frame{ exporter.spareFrame() };
+                frame.generation = t_generation;
+
+                if (t_rendererPtr != nullptr)
+                {
+                    t_rendererPtr->render(t_config, t_grid, frame);
+                }
+                else
+                {
+                    drawCellsToFrame(
+                        t_grid.cells(), t_config.grid_color_on, t_config.grid_color_off, frame);
+                }
+
+                exporter.submit(std::move(frame));
+            } };
+
+            exportFrame(0);
+
+            std::size_t generation{ 0 };
+            while (generation < t_commandLine.generation_count)
+            {
+                const std::size_t stepCount{ std::min(
+                    t_commandLine.export_interval,
+                    (t_commandLine.generation_count - generation)) };
+
+                t_grid.processSteps(stepCount);
+                generation += stepCount;
+
+                // a last partial interval is stepped but not exported
+                if (stepCount == t_commandLine.export_interval)
+                {
+                    exportFrame(generation);
+                }
+            }
+
+            exporter.finish();
+
+            std::cout << "Exported " << exporter.writtenCount() << ' '
+                      << toString(t_commandLine.export_format) << " frames to "
+                      << directory.string() << ", waiting on the encoders "
+                      << exporter.stallCount() << " times" << std::endl;
+        }
+    } // namespace
+
+    void runHeadless(const Config & t_config, const CommandLine & t_commandLine)
+    {
+        const bool isExporting{ !t_commandLine.export_directory.empty() };
+
+        // made before the Grid's setup() because it makes the OpenGL context setup() needs
+        std::unique_ptr<OffscreenRenderer> rendererPtr;
+        if (isExporting && t_commandLine.is_export_rendered)
+        {
+            rendererPtr = std::make_unique<OffscreenRenderer>(t_config);
+        }
+
+        // reset() instead of setup() unless rendering, because setup() only adds what draw()
+        // needs
+        Grid grid;
+        if (rendererPtr)
+        {
+            grid.setup(t_config);
+        }
+        else
+        {
+            grid.reset(t_config);
+        }
+
+        seedBoard(grid, t_config, t_commandLine);
+
+        const std::size_t startPopulation{ grid.countAliveCells() };
+
+        std::cout << "Headless " << grid.engineName() << " engine, rule " << t_config.rule
+                  << ", " << t_config.cell_counts.x << 'x' << t_config.cell_counts.y
+                  << (t_config.is_toroidal ? " torus" : " board") << ", population "
+                  << startPopulation << ", running " << t_commandLine.generation_count
+                  << " generations..." << std::endl;
+
+        const auto startTime{ std::chrono::steady_clock::now() };
+        if (isExporting)
+        {
+            stepAndExport(grid, rendererPtr.get(), t_config, t_commandLine);
+        }
+        else
+        {
+            grid.processSteps(t_commandLine.generation_count);
+        }
+
+        const std::chrono::duration<double> elapsed{ std::chrono::steady_clock::now() -
+                                                     startTime };
+
+        const double seconds{ elapsed.count() };
+        const double generationsPerSec{ (seconds > 0.0)
+                                            ? (static_cast<double>(t_commandLine.generation_count) /
+                                               seconds)
+                                            : 0.0 };
+
+        const double cellCount{ static_cast<double>(t_config.cell_counts.x) *
+                                static_cast<double>(t_config.cell_counts.y) };
+
+        std::cout << "Seconds=" << seconds << '\n'
+                  << "Generations/sec=" << generationsPerSec << '\n'
+                  << "Cells/sec=" << (generationsPerSec * cellCount) << '\n'
+                  << "Final Population=" << grid.countAliveCells() << '\n';
+    }
+
+} // namespace gameoflife
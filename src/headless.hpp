@@ -0,0 +1,23 @@
+#ifndef HEADLESS_HPP_INCLUDED
+#define HEADLESS_HPP_INCLUDED
+//
+// headless.hpp
+//
+#include "command-line.hpp"
+#include "config.hpp"
+
+namespace gameoflife
+{
+
+    // Runs the simulation with no window, shader or anything else that needs a graphics
+    // context:  seeds the board from the command line, steps it t_commandLine.generation_count
+    // times as fast as the engine can, and prints how fast that was and the final population.
+    //
+    // With t_commandLine.export_directory it also hands every export_interval-th generation to
+    // a FrameExporter, either one pixel per cell or through an OffscreenRenderer.  The time
+    // then includes making the frames and waiting for the last of them to be written.
+    void runHeadless(const Config & t_config, const CommandLine & t_commandLine);
+
+} // namespace gameoflife
+
+#endif // HEADLESS_HPP_INCLUDED
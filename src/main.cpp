@@ -2,17 +2,32 @@
 #include <exception>
 #include <iostream>
 
+#include "command-line.hpp"
 #include "coordinator.hpp"
+#include "headless.hpp"
 
-int main(void)
+int main(int argc, char * argv[])
 {
     try
     {
         using namespace gameoflife;
 
         Config config;
-        Coordinator coordinator;
-        coordinator.run(config);
+        const CommandLine commandLine{ parseCommandLine(argc, argv, config) };
+
+        if (commandLine.is_help_requested)
+        {
+            std::cout << commandLineHelp();
+        }
+        else if (commandLine.is_headless)
+        {
+            runHeadless(config, commandLine);
+        }
+        else
+        {
+            Coordinator coordinator;
+            coordinator.run(config);
+        }
     }
     catch (const std::exception & ex)
     {
@@ -0,0 +1,97 @@
+//
+// offscreen-renderer.cpp
+//
+#include "offscreen-renderer.hpp"
+
+#include <SFML/Graphics/Image.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace gameoflife
+{
+
+    namespace
+    {
+        // the same as the window uses, see Coordinator::setup()
+        constexpr std::size_t blur_multipass_count{ 3 };
+    } // namespace
+
+    OffscreenRenderer::OffscreenRenderer(const Config & t_config)
+        : m_sceneTexture{}
+        , m_bloomTexture{}
+        , m_bloomEffectPtr{}
+        , m_cpuBloomPtr{}
+        , m_density{}
+    {
+        const sf::Vector2u size{ t_config.video_mode.size };
+        if (!m_sceneTexture.resize(size))
+        {
+            throw std::runtime_error(
+                "OffscreenRenderer could not be constructed because sf::RenderTexture::resize() "
+                "failed.");
+        }
+
+        if (t_config.bloom_quality == util::BloomQuality::Off)
+        {
+            return;
+        }
+
+        if (util::BloomEffect::isSupported())
+        {
+            if (!m_bloomTexture.resize(size))
+            {
+                throw std::runtime_error(
+                    "OffscreenRenderer could not be constructed because the bloom's "
+                    "sf::RenderTexture::resize() failed.");
+            }
+
+            m_bloomEffectPtr = std::make_unique<util::BloomEffect>();
+            m_bloomEffectPtr->quality(t_config.bloom_quality);
+            m_bloomEffectPtr->blurMultiPassCount(blur_multipass_count);
+        }
+        else
+        {
+            m_cpuBloomPtr = std::make_unique<CpuBloom>(t_config.thread_count);
+            m_cpuBloomPtr->quality(t_config.bloom_quality);
+            m_cpuBloomPtr->blurMultiPassCount(blur_multipass_count);
+        }
+    }
+
+    void OffscreenRenderer::render(const Config & t_config, const Grid & t_grid, Frame & t_frame)
+    {
+        m_density.update(t_grid.cells());
+
+        m_sceneTexture.clear(sf::Color::Black);
+        t_grid.draw(t_config, t_grid.cells(), m_density, m_sceneTexture, {});
+        m_sceneTexture.display();
+
+        sf::RenderTexture * finalTexturePtr{ &m_sceneTexture };
+        if (m_bloomEffectPtr)
+        {
+            m_bloomEffectPtr->apply(m_sceneTexture, m_bloomTexture);
+            m_bloomTexture.display();
+            finalTexturePtr = &m_bloomTexture;
+        }
+
+        // waits for the GPU, so this is where most of the time goes
+        const sf::Image image{ finalTexturePtr->getTexture().copyToImage() };
+        t_frame.size = image.getSize();
+
+        const std::size_t byteCount{ static_cast<std::size_t>(t_frame.size.x) * t_frame.size.y *
+                                     4 };
+
+        t_frame.pixels.resize(byteCount);
+
+        if (m_cpuBloomPtr)
+        {
+            m_cpuBloomPtr->apply(image.getPixelsPtr(), t_frame.pixels.data(), t_frame.size);
+        }
+        else
+        {
+            const std::uint8_t * const pixels{ image.getPixelsPtr() };
+            std::copy(pixels, (pixels + byteCount), t_frame.pixels.begin());
+        }
+    }
+
+} // namespace gameoflife
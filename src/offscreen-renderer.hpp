@@ -0,0 +1,45 @@
+#ifndef OFFSCREEN_RENDERER_HPP_INCLUDED
+#define OFFSCREEN_RENDERER_HPP_INCLUDED
+//
+// offscreen-renderer.hpp
+//
+#include "bloom-shader.hpp"
+#include "config.hpp"
+#include "cpu-bloom.hpp"
+#include "density-pyramid.hpp"
+#include "frame-exporter.hpp"
+#include "grid.hpp"
+
+#include <SFML/Graphics/RenderTexture.hpp>
+
+#include <memory>
+
+namespace gameoflife
+{
+
+    // Draws a Grid the way the window would, bloom and all, into render textures the size of
+    // t_config.video_mode instead, and reads each result back as a Frame.  The bloom is done
+    // by util::BloomEffect where there are shaders and by CpuBloom where there aren't.
+    //
+    // Make one before calling Grid::setup(), because its render textures make the OpenGL
+    // context that the Grid's CellShader needs.
+    class OffscreenRenderer
+    {
+      public:
+        // throws std::runtime_error if the render textures can't be made
+        explicit OffscreenRenderer(const Config & t_config);
+
+        // t_grid must have been setup(), and t_frame's pixels are reused
+        void render(const Config & t_config, const Grid & t_grid, Frame & t_frame);
+
+      private:
+        sf::RenderTexture m_sceneTexture;
+        sf::RenderTexture m_bloomTexture; // only used by m_bloomEffectPtr
+        std::unique_ptr<util::BloomEffect> m_bloomEffectPtr;
+        std::unique_ptr<CpuBloom> m_cpuBloomPtr; // only without shaders
+        DensityPyramid m_density;
+    };
+
+} // namespace gameoflife
+
+#endif // OFFSCREEN_RENDERER_HPP_INCLUDED
@@ -0,0 +1,309 @@
+//
+// patterns.cpp
+//
+#include "patterns.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+
+namespace gameoflife
+{
+
+    namespace
+    {
+        // both formats are read as if the top-left was (0,0) and then centered
+        void centerCells(std::vector<sf::Vector2i> & t_cells)
+        {
+            sf::Vector2i max{ 0, 0 };
+            for (const sf::Vector2i & cell : t_cells)
+            {
+                max.x = std::max(max.x, cell.x);
+                max.y = std::max(max.y, cell.y);
+            }
+
+            for (sf::Vector2i & cell : t_cells)
+            {
+                cell -= (max / 2);
+            }
+        }
+
+        // see https://conwaylife.com/wiki/Run_Length_Encoded
+        std::vector<sf::Vector2i> parseRle(std::istream & t_stream, const std::string & t_path)
+        {
+            std::vector<sf::Vector2i> cells;
+            sf::Vector2i position{ 0, 0 };
+            int runLength{ 0 };
+            bool isHeaderFound{ false };
+
+            std::string line;
+            while (std::getline(t_stream, line))
+            {
+                if (line.empty() || (line.front() == '#'))
+                {
+                    continue;
+                }
+
+                // the "x = 3, y = 3, rule = B3/S23" line
+                if (!isHeaderFound)
+                {
+                    isHeaderFound = true;
+                    if (line.front() == 'x')
+                    {
+                        continue;
+                    }
+                }
+
+                for (const char character : line)
+                {
+                    if (std::isdigit(static_cast<unsigned char>(character)))
+                    {
+                        runLength = ((runLength * 10) + (character - '0'));
+                        continue;
+                    }
+
+                    const int count{ std::max(1, runLength) };
+                    runLength = 0;
+
+                    if ((character == 'b') || (character == '.'))
+                    {
+                        position.x += count;
+                    }
+                    else if ((character == 'o') || (character == 'A'))
+                    {
+                        for (int i{ 0 }; i < count; ++i)
+                        {
+                            cells.push_back(position);
+                            ++position.x;
+                        }
+                    }
+                    else if (character == '$')
+                    {
+                        position.x = 0;
+                        position.y += count;
+                    }
+                    else if (character == '!')
+                    {
+                        return cells;
+                    }
+                    else if (!std::isspace(static_cast<unsigned char>(character)))
+                    {
+                        throw std::runtime_error(
+                            "Pattern file \"" + t_path + "\" has an unknown RLE character '" +
+                            character + "'.");
+                    }
+                }
+            }
+
+            return cells;
+        }
+
+        // see https://conwaylife.com/wiki/Plaintext
+        std::vector<sf::Vector2i> parsePlaintext(std::istream & t_stream)
+        {
+            std::vector<sf::Vector2i> cells;
+
+            int y{ 0 };
+            std::string line;
+            while (std::getline(t_stream, line))
+            {
+                if (!line.empty() && (line.front() == '!'))
+                {
+                    continue;
+                }
+
+                for (std::size_t x{ 0 }; x < line.size(); ++x)
+                {
+                    if ((line[x] == 'O') || (line[x] == '*'))
+                    {
+                        cells.push_back({ static_cast<int>(x), y });
+                    }
+                }
+
+                ++y;
+            }
+
+            return cells;
+        }
+
+        std::vector<Pattern> makePresetPatterns()
+        {
+            std::vector<Pattern> patterns;
+
+            patterns.push_back({ "glider", { { 3, 0 }, { 3, 1 }, { 3, 2 }, { 2, 2 }, { 1, 1 } } });
+
+            patterns.push_back(
+                { "r-pentomino", { { 0, 0 }, { 0, 1 }, { 0, 2 }, { 1, 0 }, { -1, 1 } } });
+
+            patterns.push_back(
+                { "diehard",
+                  { { -5, 0 }, { -4, 0 }, { -4, 1 }, { 0, 1 }, { 1, 1 }, { 2, 1 }, { 1, -1 } } });
+
+            patterns.push_back(
+                { "acorn",
+                  { { -3, 0 }, { -2, 0 }, { -2, -2 }, { 0, -1 }, { 1, 0 }, { 2, 0 }, { 3, 0 } } });
+
+            patterns.push_back({ "infinite-block-1",
+                                 { { -4, 0 },
+                                   { -2, 0 },
+                                   { -2, -1 },
+                                   { 0, -2 },
+                                   { 0, -3 },
+                                   { 0, -4 },
+                                   { 2, -3 },
+                                   { 2, -4 },
+                                   { 2, -5 },
+                                   { 3, -4 } } });
+
+            patterns.push_back({ "infinite-block-2",
+                                 { { -3, 0 },
+                                   { -2, 0 },
+                                   { -1, 0 },
+                                   { 1, 0 },
+                                   { -3, 1 },
+                                   { 0, 2 },
+                                   { 1, 2 },
+                                   { -2, 3 },
+                                   { -1, 3 },
+                                   { 1, 3 },
+                                   { -3, 4 },
+                                   { -1, 4 },
+                                   { 1, 4 } } });
+
+            Pattern pentaDecathlon{ "penta-decathlon", {} };
+            for (int y{ -1 }; y < 2; ++y)
+            {
+                for (int x{ -4 }; x < 4; ++x)
+                {
+                    if ((0 != y) || ((-3 != x) && (2 != x)))
+                    {
+                        pentaDecathlon.cells.push_back({ x, y });
+                    }
+                }
+            }
+
+            patterns.push_back(pentaDecathlon);
+
+            // a line of 39 with gaps
+            Pattern brokenLine{ "broken-line", {} };
+            const std::vector<int> gaps{ -11, -5, -4, -3, 1, 2, 3, 4, 5, 6, 14 };
+            for (int x{ -19 }; x <= 19; ++x)
+            {
+                if (std::find(std::begin(gaps), std::end(gaps), x) == std::end(gaps))
+                {
+                    brokenLine.cells.push_back({ x, 0 });
+                }
+            }
+
+            patterns.push_back(brokenLine);
+
+            // the first gun ever found, it makes a new glider every 30 generations
+            std::istringstream gosperGliderGun{ "........................O...........\n"
+                                                "......................O.O...........\n"
+                                                "............OO......OO............OO\n"
+                                                "...........O...O....OO............OO\n"
+                                                "OO........O.....O...OO..............\n"
+                                                "OO........O...O.OO....O.O...........\n"
+                                                "..........O.....O.......O...........\n"
+                                                "...........O...O....................\n"
+                                                "............OO......................\n" };
+
+            Pattern gun{ "gosper-glider-gun", parsePlaintext(gosperGliderGun) };
+            centerCells(gun.cells);
+            patterns.push_back(gun);
+
+            return patterns;
+        }
+    } // namespace
+
+    const std::vector<Pattern> & presetPatterns()
+    {
+        static const std::vector<Pattern> patterns{ makePresetPatterns() };
+        return patterns;
+    }
+
+    const Pattern * findPresetPattern(const std::string_view t_name)
+    {
+        for (const Pattern & pattern : presetPatterns())
+        {
+            if (pattern.name == t_name)
+            {
+                return &pattern;
+            }
+        }
+
+        return nullptr;
+    }
+
+    Pattern loadPatternFile(const std::string & t_path)
+    {
+        std::ifstream file{ t_path };
+        if (!file)
+        {
+            throw std::runtime_error("Unable to open pattern file \"" + t_path + "\".");
+        }
+
+        std::string extension{ t_path.substr(t_path.find_last_of('.') + 1) };
+        for (char & character : extension)
+        {
+            character = static_cast<char>(std::tolower(static_cast<unsigned char>(character)));
+        }
+
+        Pattern pattern{ t_path, {} };
+        pattern.cells = ((extension == "rle") ? parseRle(file, t_path) : parsePlaintext(file));
+        centerCells(pattern.cells);
+        return pattern;
+    }
+
+    void placePattern(Grid & t_grid, const Pattern & t_pattern, const GridPos_t & t_center)
+    {
+        for (const sf::Vector2i & cell : t_pattern.cells)
+        {
+            t_grid.setCellValue((t_center + cell), 1);
+        }
+    }
+
+    Pattern makeRandomPattern(
+        const sf::Vector2u & t_size, const float t_density, const unsigned t_seed)
+    {
+        std::mt19937 generator{ t_seed };
+        std::bernoulli_distribution isAlive{ static_cast<double>(t_density) };
+
+        // centered the same way as a board, so placed at a board's center it fills the board
+        const sf::Vector2i center{ t_size / 2u };
+
+        Pattern pattern{ "random", {} };
+        for (int y{ 0 }; y < static_cast<int>(t_size.y); ++y)
+        {
+            for (int x{ 0 }; x < static_cast<int>(t_size.x); ++x)
+            {
+                if (isAlive(generator))
+                {
+                    pattern.cells.push_back(sf::Vector2i{ x, y } - center);
+                }
+            }
+        }
+
+        return pattern;
+    }
+
+    void fillRandomCells(CellBuffer & t_cells, const float t_density, const unsigned t_seed)
+    {
+        std::mt19937 generator{ t_seed };
+        std::bernoulli_distribution isAlive{ static_cast<double>(t_density) };
+
+        // in the same order as makeRandomPattern() so the same seed gives the same cells
+        for (std::size_t y{ 0 }; y < t_cells.height(); ++y)
+        {
+            CellType_t * const row{ t_cells.row(y) };
+            for (std::size_t x{ 0 }; x < t_cells.width(); ++x)
+            {
+                row[x] = (isAlive(generator) ? 1 : 0);
+            }
+        }
+    }
+
+} // namespace gameoflife
@@ -0,0 +1,48 @@
+#ifndef PATTERNS_HPP_INCLUDED
+#define PATTERNS_HPP_INCLUDED
+//
+// patterns.hpp
+//
+#include "grid.hpp"
+
+#include <SFML/System/Vector2.hpp>
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace gameoflife
+{
+
+    struct Pattern
+    {
+        std::string name;
+        std::vector<sf::Vector2i> cells; // the live cells, as offsets from the pattern's center
+    };
+
+    // the presets on the number keys, in order
+    const std::vector<Pattern> & presetPatterns();
+
+    // returns nullptr if there is no preset with that name
+    const Pattern * findPresetPattern(const std::string_view t_name);
+
+    // Reads a run length encoded (.rle) or plaintext (.cells) pattern file, depending on the
+    // extension.  Throws std::runtime_error if the file can't be opened or understood.
+    Pattern loadPatternFile(const std::string & t_path);
+
+    // cells that land off the board are ignored
+    void placePattern(Grid & t_grid, const Pattern & t_pattern, const GridPos_t & t_center);
+
+    // a t_size rectangle where each cell is alive with a chance of t_density, the same seed
+    // gives the same cells every time
+    Pattern makeRandomPattern(
+        const sf::Vector2u & t_size, const float t_density, const unsigned t_seed);
+
+    // The same cells as makeRandomPattern() of t_cells' size placed at its center, but written
+    // straight into t_cells, which is far cheaper for big boards than a list of every live cell.
+    void fillRandomCells(CellBuffer & t_cells, const float t_density, const unsigned t_seed);
+
+} // namespace gameoflife
+
+#endif // PATTERNS_HPP_INCLUDED
@@ -0,0 +1,84 @@
+//
+// rule.cpp
+//
+#include "rule.hpp"
+
+#include <cctype>
+#include <stdexcept>
+
+namespace gameoflife
+{
+
+    namespace
+    {
+        // parses the digits after the 'B' or 'S' at the start of t_text
+        std::uint16_t parseCounts(const std::string_view t_text, const char t_letter)
+        {
+            if (t_text.empty() ||
+                (std::toupper(static_cast<unsigned char>(t_text.front())) != t_letter))
+            {
+                return 0xFFFF;
+            }
+
+            std::uint16_t counts{ 0 };
+            for (const char digit : t_text.substr(1))
+            {
+                if ((digit < '0') || (digit > '8'))
+                {
+                    return 0xFFFF;
+                }
+
+                counts |= static_cast<std::uint16_t>(1u << (digit - '0'));
+            }
+
+            return counts;
+        }
+
+        std::string countsToString(const std::uint16_t t_counts)
+        {
+            std::string text;
+            for (char count{ 0 }; count <= 8; ++count)
+            {
+                if (((t_counts >> count) & 1) != 0)
+                {
+                    text += static_cast<char>('0' + count);
+                }
+            }
+
+            return text;
+        }
+    } // namespace
+
+    Rule parseRule(const std::string_view t_text)
+    {
+        const std::size_t slashIndex{ t_text.find('/') };
+
+        const std::uint16_t birth{ (slashIndex == std::string_view::npos)
+                                       ? std::uint16_t{ 0xFFFF }
+                                       : parseCounts(t_text.substr(0, slashIndex), 'B') };
+
+        const std::uint16_t survival{ (slashIndex == std::string_view::npos)
+                                          ? std::uint16_t{ 0xFFFF }
+                                          : parseCounts(t_text.substr(slashIndex + 1), 'S') };
+
+        if ((birth == 0xFFFF) || (survival == 0xFFFF))
+        {
+            throw std::runtime_error(
+                "Invalid rule \"" + std::string{ t_text } +
+                "\", expected B/S notation like \"B3/S23\" or \"B36/S23\".");
+        }
+
+        return { birth, survival };
+    }
+
+    std::string toString(const Rule & t_rule)
+    {
+        // appending instead of "B" + ... keeps GCC 12 from a false -Wrestrict warning
+        std::string text{ "B" };
+        text += countsToString(t_rule.birth);
+        text += "/S";
+        text += countsToString(t_rule.survival);
+        return text;
+    }
+
+} // namespace gameoflife
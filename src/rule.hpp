@@ -0,0 +1,46 @@
+#ifndef RULE_HPP_INCLUDED
+#define RULE_HPP_INCLUDED
+//
+// rule.hpp
+//
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace gameoflife
+{
+
+    // A Life-like rule, where the next state of a cell only depends on if it is alive and on
+    // how many of its eight neighbours are.  Bit n of birth means a dead cell with n live
+    // neighbours comes alive, and bit n of survival means a live cell with n stays alive.
+    struct Rule
+    {
+        std::uint16_t birth{ 0 };
+        std::uint16_t survival{ 0 };
+
+        constexpr bool operator==(const Rule &) const = default;
+
+        constexpr bool isAliveNext(const bool t_isAlive, const std::size_t t_count) const
+        {
+            return ((((t_isAlive ? survival : birth) >> t_count) & 1) != 0);
+        }
+
+        // the unbounded engines can't have empty space coming alive
+        constexpr bool isBornFromNothing() const { return ((birth & 1) != 0); }
+    };
+
+    // the rules common enough to get kernels built just for them
+    constexpr Rule conway_rule{ 0b000001000, 0b000001100 };        // B3/S23
+    constexpr Rule highlife_rule{ 0b001001000, 0b000001100 };      // B36/S23
+    constexpr Rule seeds_rule{ 0b000000100, 0b000000000 };         // B2/S
+    constexpr Rule day_and_night_rule{ 0b111001000, 0b111011000 }; // B3678/S34678
+
+    // B/S notation like "B36/S23", in either case, throws std::runtime_error if it isn't
+    Rule parseRule(const std::string_view t_text);
+
+    std::string toString(const Rule & t_rule);
+
+} // namespace gameoflife
+
+#endif // RULE_HPP_INCLUDED
@@ -0,0 +1,286 @@
+//
+// sparse-engine.cpp
+//
+#include "sparse-engine.hpp"
+
+#include <algorithm>
+#include <bit>
+
+namespace gameoflife
+{
+
+    namespace
+    {
+        // 256 chunks is the same 16K words that BitEngine gives each thread
+        constexpr std::size_t min_chunks_per_band{ 256 };
+    } // namespace
+
+    std::size_t SparseEngine::KeyHash::operator()(const Key_t t_key) const
+    {
+        // neighbouring chunks only differ in the low bits of each half, so mix them
+        const std::uint64_t hash{ t_key * 0x9E3779B97F4A7C15ull };
+        return std::hash<std::uint64_t>{}(hash ^ (hash >> 32));
+    }
+
+    SparseEngine::SparseEngine(ThreadPool & t_threadPool, const Rule & t_rule)
+        : m_threadPool{ t_threadPool }
+        , m_rule{ t_rule }
+        , m_chunks{}
+        , m_candidateKeys{}
+        , m_nextChunks{}
+        , m_isNextAlive{}
+    {}
+
+    SparseEngine::Key_t
+        SparseEngine::makeKey(const std::uint32_t t_chunkX, const std::uint32_t t_chunkY)
+    {
+        return ((Key_t{ t_chunkX } << 32) | Key_t{ t_chunkY });
+    }
+
+    SparseEngine::Key_t
+        SparseEngine::neighbourKey(const Key_t t_key, const int t_offsetX, const int t_offsetY)
+    {
+        // unsigned so that moving past either end wraps instead of overflowing
+        const std::uint32_t chunkX{ static_cast<std::uint32_t>(t_key >> 32) };
+        const std::uint32_t chunkY{ static_cast<std::uint32_t>(t_key) };
+
+        return makeKey(
+            (chunkX + static_cast<std::uint32_t>(t_offsetX)),
+            (chunkY + static_cast<std::uint32_t>(t_offsetY)));
+    }
+
+    std::uint64_t SparseEngine::population() const
+    {
+        std::uint64_t count{ 0 };
+        for (const auto & [key, chunk] : m_chunks)
+        {
+            for (const Word_t word : chunk)
+            {
+                count += static_cast<std::uint64_t>(std::popcount(word));
+            }
+        }
+
+        return count;
+    }
+
+    void SparseEngine::load(const CellBuffer & t_cells)
+    {
+        m_chunks.clear();
+
+        for (std::size_t top{ 0 }; top < t_cells.height(); top += chunk_size)
+        {
+            for (std::size_t left{ 0 }; left < t_cells.width(); left += chunk_size)
+            {
+                const std::size_t rowCount{ std::min(chunk_size, (t_cells.height() - top)) };
+                const std::size_t cellCount{ std::min(chunk_size, (t_cells.width() - left)) };
+
+                Chunk_t chunk{};
+                Word_t allWords{ 0 };
+                for (std::size_t y{ 0 }; y < rowCount; ++y)
+                {
+                    packRow((t_cells.row(top + y) + left), cellCount, &chunk[y]);
+                    allWords |= chunk[y];
+                }
+
+                if (allWords != 0)
+                {
+                    m_chunks.emplace(
+                        makeKey(
+                            static_cast<std::uint32_t>(left / chunk_size),
+                            static_cast<std::uint32_t>(top / chunk_size)),
+                        chunk);
+                }
+            }
+        }
+    }
+
+    void SparseEngine::store(CellBuffer & t_cells) const
+    {
+        t_cells.clear();
+
+        const std::int64_t width{ static_cast<std::int64_t>(t_cells.width()) };
+        const std::int64_t height{ static_cast<std::int64_t>(t_cells.height()) };
+        const std::int64_t size{ static_cast<std::int64_t>(chunk_size) };
+
+        for (const auto & [key, chunk] : m_chunks)
+        {
+            // back to signed so chunks left of or above the board are skipped
+            const std::int64_t left{ std::int64_t{ static_cast<std::int32_t>(key >> 32) } * size };
+            const std::int64_t top{ std::int64_t{ static_cast<std::int32_t>(key & 0xFFFFFFFFu) } *
+                                    size };
+
+            if (((left + size) <= 0) || ((top + size) <= 0) || (left >= width) || (top >= height))
+            {
+                continue;
+            }
+
+            for (std::int64_t y{ std::max(std::int64_t{ 0 }, top) };
+                 y < std::min(height, (top + size));
+                 ++y)
+            {
+                CellType_t * cells{ t_cells.row(static_cast<std::size_t>(y)) };
+
+                Word_t word{ chunk[static_cast<std::size_t>(y - top)] };
+                while (word != 0)
+                {
+                    const std::int64_t x{ left + std::countr_zero(word) };
+                    if ((x >= 0) && (x < width))
+                    {
+                        cells[x] = 1;
+                    }
+
+                    word &= (word - 1);
+                }
+            }
+        }
+    }
+
+    void SparseEngine::addCandidates(const Key_t t_key, const Chunk_t & t_chunk)
+    {
+        m_candidateKeys.push_back(t_key);
+
+        Word_t westColumn{ 0 };
+        Word_t eastColumn{ 0 };
+        for (const Word_t word : t_chunk)
+        {
+            westColumn |= word;
+            eastColumn |= word;
+        }
+
+        westColumn &= 1;
+        eastColumn >>= (bits_per_word - 1);
+
+        const Word_t topRow{ t_chunk.front() };
+        const Word_t bottomRow{ t_chunk.back() };
+        const Word_t lastBit{ Word_t{ 1 } << (bits_per_word - 1) };
+
+        const auto addIf = [&](const bool t_isNeeded, const int t_offsetX, const int t_offsetY) {
+            if (t_isNeeded)
+            {
+                m_candidateKeys.push_back(neighbourKey(t_key, t_offsetX, t_offsetY));
+            }
+        };
+
+        addIf((topRow != 0), 0, -1);
+        addIf((bottomRow != 0), 0, 1);
+        addIf((westColumn != 0), -1, 0);
+        addIf((eastColumn != 0), 1, 0);
+        addIf(((topRow & 1) != 0), -1, -1);
+        addIf(((topRow & lastBit) != 0), 1, -1);
+        addIf(((bottomRow & 1) != 0), -1, 1);
+        addIf(((bottomRow & lastBit) != 0), 1, 1);
+    }
+
+    const SparseEngine::Chunk_t & SparseEngine::chunkAt(const Key_t t_key) const
+    {
+        static const Chunk_t dead_chunk{};
+
+        const auto iter{ m_chunks.find(t_key) };
+        return ((iter == m_chunks.end()) ? dead_chunk : iter->second);
+    }
+
+    template <typename Stepper_t>
+    bool SparseEngine::stepChunk(
+        const Key_t t_key, Chunk_t & t_next, const Stepper_t & t_step) const
+    {
+        const Chunk_t & north{ chunkAt(neighbourKey(t_key, 0, -1)) };
+        const Chunk_t & northWest{ chunkAt(neighbourKey(t_key, -1, -1)) };
+        const Chunk_t & northEast{ chunkAt(neighbourKey(t_key, 1, -1)) };
+        const Chunk_t & west{ chunkAt(neighbourKey(t_key, -1, 0)) };
+        const Chunk_t & middle{ chunkAt(t_key) };
+        const Chunk_t & east{ chunkAt(neighbourKey(t_key, 1, 0)) };
+        const Chunk_t & south{ chunkAt(neighbourKey(t_key, 0, 1)) };
+        const Chunk_t & southWest{ chunkAt(neighbourKey(t_key, -1, 1)) };
+        const Chunk_t & southEast{ chunkAt(neighbourKey(t_key, 1, 1)) };
+
+        const std::size_t last{ chunk_size - 1 };
+
+        Word_t allWords{ 0 };
+        for (std::size_t y{ 0 }; y < chunk_size; ++y)
+        {
+            // the rows above and below come from the chunks above and below at the edges
+            const Chunk_t & aboveWest{ (y == 0) ? northWest : west };
+            const Chunk_t & above{ (y == 0) ? north : middle };
+            const Chunk_t & aboveEast{ (y == 0) ? northEast : east };
+            const std::size_t aboveY{ (y == 0) ? last : (y - 1) };
+
+            const Chunk_t & belowWest{ (y == last) ? southWest : west };
+            const Chunk_t & below{ (y == last) ? south : middle };
+            const Chunk_t & belowEast{ (y == last) ? southEast : east };
+            const std::size_t belowY{ (y == last) ? 0 : (y + 1) };
+
+            const Word_t word{ t_step(
+                aboveWest[aboveY],
+                above[aboveY],
+                aboveEast[aboveY],
+                west[y],
+                middle[y],
+                east[y],
+                belowWest[belowY],
+                below[belowY],
+                belowEast[belowY]) };
+
+            t_next[y] = word;
+            allWords |= word;
+        }
+
+        return (allWords != 0);
+    }
+
+    void SparseEngine::processStep()
+    {
+        m_candidateKeys.clear();
+        for (const auto & [key, chunk] : m_chunks)
+        {
+            addCandidates(key, chunk);
+        }
+
+        std::sort(std::begin(m_candidateKeys), std::end(m_candidateKeys));
+
+        m_candidateKeys.erase(
+            std::unique(std::begin(m_candidateKeys), std::end(m_candidateKeys)),
+            std::end(m_candidateKeys));
+
+        m_nextChunks.resize(m_candidateKeys.size());
+        m_isNextAlive.resize(m_candidateKeys.size());
+
+        // the map is only read here, and each band writes only its own results
+        withWordStepper(m_rule, [&](const auto & t_step) {
+            m_threadPool.forEachBand(
+                m_candidateKeys.size(),
+                min_chunks_per_band,
+                [&](const std::size_t t_begin, const std::size_t t_end) {
+                    for (std::size_t index{ t_begin }; index < t_end; ++index)
+                    {
+                        m_isNextAlive[index] =
+                            stepChunk(m_candidateKeys[index], m_nextChunks[index], t_step);
+                    }
+                });
+        });
+
+        // overwrite in place so chunks that live on keep their map node
+        for (std::size_t index{ 0 }; index < m_candidateKeys.size(); ++index)
+        {
+            if (m_isNextAlive[index] == 0)
+            {
+                m_chunks.erase(m_candidateKeys[index]);
+            }
+            else
+            {
+                m_chunks[m_candidateKeys[index]] = m_nextChunks[index];
+            }
+        }
+    }
+
+    std::size_t SparseEngine::byteCount() const
+    {
+        // a guess at each map node, since the standard doesn't say how big they are
+        const std::size_t mapNodeBytes{ sizeof(Key_t) + sizeof(Chunk_t) + (2 * sizeof(void *)) };
+
+        return (
+            (m_chunks.size() * mapNodeBytes) + (m_chunks.bucket_count() * sizeof(void *)) +
+            (m_candidateKeys.capacity() * sizeof(Key_t)) +
+            (m_nextChunks.capacity() * sizeof(Chunk_t)) + m_isNextAlive.capacity());
+    }
+
+} // namespace gameoflife
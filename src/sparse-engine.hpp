@@ -0,0 +1,82 @@
+#ifndef SPARSE_ENGINE_HPP_INCLUDED
+#define SPARSE_ENGINE_HPP_INCLUDED
+//
+// sparse-engine.hpp
+//
+#include "bit-kernel.hpp"
+#include "engine.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace gameoflife
+{
+
+    // An unbounded plane of 64x64 chunks kept in a hash map by chunk coordinate.  Only chunks
+    // holding live cells are kept, so memory follows the live area and not the bounding box,
+    // and a glider can fly off forever while only ever costing one or two chunks.
+    //
+    // Each step looks at every chunk plus the neighbours that live cells on its edges could
+    // spill into, steps them with the same word kernel as BitEngine, and drops any that die.
+    //
+    // Rules where empty space comes alive (B0) can't work on an unbounded plane.
+    //
+    // Like HashLifeEngine, load() puts the board's top-left at (0,0) and store() only copies
+    // back what is inside the board.  Chunk coordinates wrap around at 2^32 chunks.
+    class SparseEngine : public IEngine
+    {
+      public:
+        SparseEngine(ThreadPool & t_threadPool, const Rule & t_rule);
+        virtual ~SparseEngine() override = default;
+
+        std::string_view name() const override { return "sparse"; }
+
+        void load(const CellBuffer & t_cells) override;
+        void store(CellBuffer & t_cells) const override;
+        std::size_t byteCount() const override;
+        void processStep() override;
+
+        std::size_t chunkCount() const { return m_chunks.size(); }
+        std::uint64_t population() const;
+
+      private:
+        static constexpr std::size_t chunk_size{ bits_per_word };
+
+        // row by row, one word per row
+        using Chunk_t = std::array<Word_t, chunk_size>;
+
+        // x in the high half and y in the low half
+        using Key_t = std::uint64_t;
+
+        struct KeyHash
+        {
+            std::size_t operator()(const Key_t t_key) const;
+        };
+
+        static Key_t makeKey(const std::uint32_t t_chunkX, const std::uint32_t t_chunkY);
+        static Key_t neighbourKey(const Key_t t_key, const int t_offsetX, const int t_offsetY);
+
+        // adds the chunk and the neighbours its live edge cells could be born into
+        void addCandidates(const Key_t t_key, const Chunk_t & t_chunk);
+
+        // returns false if the whole chunk will be dead
+        template <typename Stepper_t>
+        bool stepChunk(const Key_t t_key, Chunk_t & t_next, const Stepper_t & t_step) const;
+
+        const Chunk_t & chunkAt(const Key_t t_key) const;
+
+      private:
+        ThreadPool & m_threadPool;
+        Rule m_rule;
+        std::unordered_map<Key_t, Chunk_t, KeyHash> m_chunks;
+        std::vector<Key_t> m_candidateKeys;
+        std::vector<Chunk_t> m_nextChunks; // same order as m_candidateKeys
+        std::vector<std::uint8_t> m_isNextAlive;
+    };
+
+} // namespace gameoflife
+
+#endif // SPARSE_ENGINE_HPP_INCLUDED
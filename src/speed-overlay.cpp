@@ -0,0 +1,133 @@
+//
+// speed-overlay.cpp
+//
+#include "speed-overlay.hpp"
+
+#include "sfml-util.hpp"
+
+#include <SFML/Graphics/PrimitiveType.hpp>
+
+#include <array>
+#include <string>
+
+namespace gameoflife
+{
+
+    namespace
+    {
+        // segments a to g as bits 0 to 6, clockwise from the top and then the middle
+        constexpr std::array<unsigned, 10> digit_segments{
+            0b0111111, 0b0000110, 0b1011011, 0b1001111, 0b1100110,
+            0b1101101, 0b1111101, 0b0000111, 0b1111111, 0b1101111
+        };
+
+        // all relative to the height of a digit
+        constexpr float digit_width_ratio{ 0.5f };
+        constexpr float segment_thickness_ratio{ 0.125f };
+        constexpr float digit_gap_ratio{ 0.2f };
+        constexpr float group_gap_ratio{ 0.3f };
+        constexpr float box_pad_ratio{ 0.25f };
+
+        const sf::Color box_color{ 0, 0, 0, 192 };
+    } // namespace
+
+    SpeedOverlay::SpeedOverlay(const Config & t_config)
+        : m_position{}
+        , m_digitHeight{ 0.0f }
+        , m_color{ t_config.grid_color_on }
+        , m_generationsPerSec{ 0 }
+        , m_verts{}
+    {
+        // half as tall as the pad above the board and centered in it
+        const sf::Vector2f screenSize{ t_config.video_mode.size };
+        const sf::Vector2f padSize{ t_config.screen_edge_pad_ratio * screenSize };
+        m_digitHeight = (padSize.y * 0.5f);
+        m_position    = { padSize.x, (padSize.y * 0.25f) };
+    }
+
+    void SpeedOverlay::generationsPerSec(const std::size_t t_count)
+    {
+        if (t_count == m_generationsPerSec)
+        {
+            return;
+        }
+
+        m_generationsPerSec = t_count;
+        m_verts.clear();
+
+        if (0 == t_count)
+        {
+            return;
+        }
+
+        const std::string digits{ std::to_string(t_count) };
+        const float digitWidth{ m_digitHeight * digit_width_ratio };
+        const float digitGap{ m_digitHeight * digit_gap_ratio };
+        const float groupGap{ m_digitHeight * group_gap_ratio };
+        const float boxPad{ m_digitHeight * box_pad_ratio };
+
+        // the box first so the digits are drawn over it, and its size is known from the count
+        const std::size_t groupCount{ (digits.size() - 1) / 3 };
+        const float textWidth{ (static_cast<float>(digits.size()) * (digitWidth + digitGap)) -
+                               digitGap + (static_cast<float>(groupCount) * groupGap) };
+
+        util::appendTriangleVerts(
+            (m_position - sf::Vector2f{ boxPad, boxPad }),
+            sf::Vector2f{ (textWidth + (boxPad * 2.0f)), (m_digitHeight + (boxPad * 2.0f)) },
+            m_verts,
+            box_color);
+
+        sf::Vector2f position{ m_position };
+        for (std::size_t index{ 0 }; index < digits.size(); ++index)
+        {
+            appendDigit(static_cast<unsigned>(digits[index] - '0'), position);
+            position.x += (digitWidth + digitGap);
+
+            // a wider gap after each digit that has a multiple of three digits after it
+            const std::size_t remainingCount{ digits.size() - index - 1 };
+            if ((remainingCount > 0) && ((remainingCount % 3) == 0))
+            {
+                position.x += groupGap;
+            }
+        }
+    }
+
+    void SpeedOverlay::draw(sf::RenderTarget & t_target, sf::RenderStates t_states) const
+    {
+        if (!m_verts.empty())
+        {
+            t_target.draw(m_verts.data(), m_verts.size(), sf::PrimitiveType::Triangles, t_states);
+        }
+    }
+
+    void SpeedOverlay::appendDigit(const unsigned t_digit, const sf::Vector2f & t_position)
+    {
+        const float height{ m_digitHeight };
+        const float width{ height * digit_width_ratio };
+        const float thickness{ height * segment_thickness_ratio };
+        const float half{ height * 0.5f };
+
+        const std::array<sf::FloatRect, 7> segments{
+            sf::FloatRect{ { 0.0f, 0.0f }, { width, thickness } },
+            sf::FloatRect{ { (width - thickness), 0.0f }, { thickness, half } },
+            sf::FloatRect{ { (width - thickness), half }, { thickness, half } },
+            sf::FloatRect{ { 0.0f, (height - thickness) }, { width, thickness } },
+            sf::FloatRect{ { 0.0f, half }, { thickness, half } },
+            sf::FloatRect{ { 0.0f, 0.0f }, { thickness, half } },
+            sf::FloatRect{ { 0.0f, ((height - thickness) * 0.5f) }, { width, thickness } }
+        };
+
+        for (std::size_t index{ 0 }; index < segments.size(); ++index)
+        {
+            if ((digit_segments[t_digit] >> index) & 1u)
+            {
+                util::appendTriangleVerts(
+                    (t_position + segments[index].position),
+                    segments[index].size,
+                    m_verts,
+                    m_color);
+            }
+        }
+    }
+
+} // namespace gameoflife
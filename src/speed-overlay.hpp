@@ -0,0 +1,46 @@
+#ifndef SPEED_OVERLAY_HPP_INCLUDED
+#define SPEED_OVERLAY_HPP_INCLUDED
+//
+// speed-overlay.hpp
+//
+#include "config.hpp"
+
+#include <SFML/Graphics/Drawable.hpp>
+#include <SFML/Graphics/RenderStates.hpp>
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+
+#include <cstddef>
+#include <vector>
+
+namespace gameoflife
+{
+
+    // The generations/sec of max speed mode as seven segment digits on a dark box, in the pad
+    // above the top-left of the board.  Digits are built from quads so no font file is needed,
+    // and they are grouped in threes so big numbers stay readable.
+    class SpeedOverlay : public sf::Drawable
+    {
+      public:
+        explicit SpeedOverlay(const Config & t_config);
+
+        // zero draws nothing
+        std::size_t generationsPerSec() const { return m_generationsPerSec; }
+        void generationsPerSec(const std::size_t t_count);
+
+        void draw(sf::RenderTarget & t_target, sf::RenderStates t_states) const override;
+
+      private:
+        void appendDigit(const unsigned t_digit, const sf::Vector2f & t_position);
+
+      private:
+        sf::Vector2f m_position;
+        float m_digitHeight;
+        sf::Color m_color;
+        std::size_t m_generationsPerSec;
+        std::vector<sf::Vertex> m_verts; // triangles
+    };
+
+} // namespace gameoflife
+
+#endif // SPEED_OVERLAY_HPP_INCLUDED
@@ -0,0 +1,246 @@
+//
+// table-engine.cpp
+//
+#include "table-engine.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <map>
+#include <mutex>
+
+namespace gameoflife
+{
+
+    namespace
+    {
+        constexpr std::size_t block_count{ 1 << 16 };
+
+        // each pair of rows is two rows of words, so this is in line with the bit engine
+        constexpr std::size_t min_words_per_band{ 16 * 1024 };
+
+        std::vector<std::uint8_t> makeTable(const Rule & t_rule)
+        {
+            std::vector<std::uint8_t> table(block_count, 0);
+
+            for (std::size_t index{ 0 }; index < block_count; ++index)
+            {
+                const auto cellAt = [&](const std::size_t t_row, const std::size_t t_column) {
+                    return ((index >> ((t_row * 4) + t_column)) & 1);
+                };
+
+                for (std::size_t row{ 1 }; row <= 2; ++row)
+                {
+                    for (std::size_t column{ 1 }; column <= 2; ++column)
+                    {
+                        std::size_t count{ 0 };
+                        for (std::size_t y{ row - 1 }; y <= (row + 1); ++y)
+                        {
+                            for (std::size_t x{ column - 1 }; x <= (column + 1); ++x)
+                            {
+                                count += cellAt(y, x);
+                            }
+                        }
+
+                        // the loops above counted the cell itself too
+                        const bool isAlive{ cellAt(row, column) != 0 };
+                        count -= (isAlive ? 1 : 0);
+
+                        if (t_rule.isAliveNext(isAlive, count))
+                        {
+                            table[index] |= static_cast<std::uint8_t>(
+                                1u << (((row - 1) * 2) + (column - 1)));
+                        }
+                    }
+                }
+            }
+
+            return table;
+        }
+
+        // Built the first time each rule is used and kept, so switching engines or resetting the
+        // board doesn't build it again.  std::map never moves its values, so the references
+        // handed out stay good.
+        const std::vector<std::uint8_t> & findTable(const Rule & t_rule)
+        {
+            static std::mutex mutex;
+            static std::map<std::uint32_t, std::vector<std::uint8_t>> tables;
+
+            const std::uint32_t key{ (static_cast<std::uint32_t>(t_rule.birth) << 16) |
+                                     t_rule.survival };
+
+            std::lock_guard<std::mutex> lock(mutex);
+            const auto iter{ tables.find(key) };
+            if (iter != tables.end())
+            {
+                return iter->second;
+            }
+
+            return tables.emplace(key, makeTable(t_rule)).first->second;
+        }
+    } // namespace
+
+    TableEngine::TableEngine(
+        ThreadPool & t_threadPool, const Rule & t_rule, const bool t_isToroidal)
+        : m_threadPool{ t_threadPool }
+        , m_isToroidal{ t_isToroidal }
+        , m_table{ findTable(t_rule) }
+        , m_width{ 0 }
+        , m_height{ 0 }
+        , m_pairCount{ 0 }
+        , m_wordsPerRow{ 0 }
+        , m_lastWordMask{ 0 }
+        , m_words{}
+        , m_nextWords{}
+    {}
+
+    void TableEngine::resize(const std::size_t t_width, const std::size_t t_height)
+    {
+        m_width       = t_width;
+        m_height      = t_height;
+        m_pairCount   = ((t_height + 1) / 2);
+        m_wordsPerRow = ((t_width + bits_per_word - 1) / bits_per_word);
+
+        const std::size_t usedBits{ t_width % bits_per_word };
+        m_lastWordMask = ((usedBits == 0) ? ~Word_t{ 0 } : ((Word_t{ 1 } << usedBits) - 1));
+
+        // an odd height gets an extra row that is always dead, plus the two padding rows
+        const std::size_t wordCount{ m_wordsPerRow * ((m_pairCount * 2) + 2) };
+        m_words.assign(wordCount, 0);
+        m_nextWords.assign(wordCount, 0);
+    }
+
+    void TableEngine::load(const CellBuffer & t_cells)
+    {
+        resize(t_cells.width(), t_cells.height());
+
+        for (std::size_t y{ 0 }; y < m_height; ++y)
+        {
+            packRow(t_cells.row(y), m_width, row(m_words, (y + 1)));
+        }
+    }
+
+    void TableEngine::store(CellBuffer & t_cells) const
+    {
+        for (std::size_t y{ 0 }; y < m_height; ++y)
+        {
+            unpackRow(row(m_words, (y + 1)), m_width, t_cells.row(y));
+        }
+    }
+
+    void TableEngine::processStep()
+    {
+        if (m_pairCount == 0)
+        {
+            return;
+        }
+
+        // on a torus the row below the last is the first row, even on an odd height board where
+        // that is the always dead extra row, because its own next cells are thrown away anyway
+        if (m_isToroidal)
+        {
+            std::copy_n(row(m_words, m_height), m_wordsPerRow, row(m_words, 0));
+            std::copy_n(row(m_words, 1), m_wordsPerRow, row(m_words, (m_height + 1)));
+        }
+
+        const std::size_t minPairsPerBand{ std::max(
+            std::size_t{ 1 }, (min_words_per_band / (m_wordsPerRow * 2))) };
+
+        m_threadPool.forEachBand(
+            m_pairCount,
+            minPairsPerBand,
+            [this](const std::size_t t_beginPair, const std::size_t t_endPair) {
+                processPairs(t_beginPair, t_endPair);
+            });
+
+        m_words.swap(m_nextWords);
+    }
+
+    void TableEngine::processPairs(const std::size_t t_beginPair, const std::size_t t_endPair)
+    {
+        const std::uint8_t * const table{ m_table.data() };
+        const std::size_t lastWord{ m_wordsPerRow - 1 };
+
+        for (std::size_t pair{ t_beginPair }; pair < t_endPair; ++pair)
+        {
+            // the pair is rows 1 and 2 of these four, counting the top padding row
+            const std::size_t topY{ pair * 2 };
+            const std::array<const Word_t *, 4> rows{ row(m_words, topY),
+                                                      row(m_words, (topY + 1)),
+                                                      row(m_words, (topY + 2)),
+                                                      row(m_words, (topY + 3)) };
+
+            std::array<RowGhosts, 4> ghosts{};
+            if (m_isToroidal)
+            {
+                for (std::size_t r{ 0 }; r < 4; ++r)
+                {
+                    ghosts[r] = wrapRow(rows[r], m_width);
+                }
+            }
+
+            Word_t * nextUpper{ row(m_nextWords, (topY + 1)) };
+            Word_t * nextLower{ row(m_nextWords, (topY + 2)) };
+
+            // the extra row of an odd height board must stay dead
+            const Word_t lowerMask{ (((pair * 2) + 1) < m_height) ? ~Word_t{ 0 } : 0 };
+
+            for (std::size_t w{ 0 }; w < m_wordsPerRow; ++w)
+            {
+                // shifted one cell right so that bit 0 is the last cell of the previous word,
+                // then the 4x4 block for output columns 2k and 2k+1 starts at bit 2k
+                std::array<Word_t, 4> shifted{};
+                std::array<Word_t, 4> tails{};
+                for (std::size_t r{ 0 }; r < 4; ++r)
+                {
+                    const Word_t prev{ (w == 0) ? ghosts[r].before : rows[r][w - 1] };
+                    const Word_t next{ (w == lastWord) ? ghosts[r].after : rows[r][w + 1] };
+                    const Word_t word{ rows[r][w] | ((w == lastWord) ? ghosts[r].inLast : 0) };
+
+                    shifted[r] = ((word << 1) | (prev >> (bits_per_word - 1)));
+
+                    // the last block runs one cell into the next word
+                    tails[r] =
+                        ((shifted[r] >> (bits_per_word - 2)) |
+                         ((word >> (bits_per_word - 1)) << 2) | ((next & 1) << 3));
+                }
+
+                const auto lookUp = [&](const Word_t t_row0,
+                                        const Word_t t_row1,
+                                        const Word_t t_row2,
+                                        const Word_t t_row3) {
+                    return Word_t{ table[t_row0 | (t_row1 << 4) | (t_row2 << 8) | (t_row3 << 12)] };
+                };
+
+                Word_t upper{ 0 };
+                Word_t lower{ 0 };
+                for (std::size_t bit{ 0 }; bit < (bits_per_word - 2); bit += 2)
+                {
+                    const Word_t next{ lookUp(
+                        ((shifted[0] >> bit) & 0xF),
+                        ((shifted[1] >> bit) & 0xF),
+                        ((shifted[2] >> bit) & 0xF),
+                        ((shifted[3] >> bit) & 0xF)) };
+
+                    upper |= ((next & 3) << bit);
+                    lower |= ((next >> 2) << bit);
+                }
+
+                const Word_t last{ lookUp(tails[0], tails[1], tails[2], tails[3]) };
+                upper |= ((last & 3) << (bits_per_word - 2));
+                lower |= ((last >> 2) << (bits_per_word - 2));
+
+                const Word_t mask{ (w == lastWord) ? m_lastWordMask : ~Word_t{ 0 } };
+                nextUpper[w] = (upper & mask);
+                nextLower[w] = (lower & mask & lowerMask);
+            }
+        }
+    }
+
+    std::size_t TableEngine::byteCount() const
+    {
+        return (
+            ((m_words.capacity() + m_nextWords.capacity()) * sizeof(Word_t)) + m_table.capacity());
+    }
+
+} // namespace gameoflife
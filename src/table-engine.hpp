@@ -0,0 +1,74 @@
+#ifndef TABLE_ENGINE_HPP_INCLUDED
+#define TABLE_ENGINE_HPP_INCLUDED
+//
+// table-engine.hpp
+//
+#include "bit-kernel.hpp"
+#include "engine.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace gameoflife
+{
+
+    // Uses a 65,536 entry table of every possible 4x4 block, each holding what its center 2x2
+    // block becomes next step.  Rows are packed into words like BitEngine, and each pair of
+    // rows is stepped two columns at a time by gathering a 4x4 block from four rows and doing
+    // one lookup.  No wide registers are needed, which suits CPUs without fast SIMD.
+    //
+    // Any rule works the same since the rule is only used to build the table, which is built
+    // once per rule and shared.  On a torus the padding rows are refreshed with the opposite
+    // rows first, like BitEngine.
+    class TableEngine : public IEngine
+    {
+      public:
+        TableEngine(ThreadPool & t_threadPool, const Rule & t_rule, const bool t_isToroidal);
+        virtual ~TableEngine() override = default;
+
+        std::string_view name() const override { return "lookup-table"; }
+
+        void load(const CellBuffer & t_cells) override;
+        void store(CellBuffer & t_cells) const override;
+        std::size_t byteCount() const override;
+        void processStep() override;
+
+      private:
+        void resize(const std::size_t t_width, const std::size_t t_height);
+
+        // [t_beginPair, t_endPair) where pair p is board rows 2p and 2p+1
+        void processPairs(const std::size_t t_beginPair, const std::size_t t_endPair);
+
+        // y=0 is the top padding row, so board row y is row(words, y+1)
+        Word_t * row(std::vector<Word_t> & t_words, const std::size_t t_y) const
+        {
+            return (t_words.data() + (t_y * m_wordsPerRow));
+        }
+
+        const Word_t * row(const std::vector<Word_t> & t_words, const std::size_t t_y) const
+        {
+            return (t_words.data() + (t_y * m_wordsPerRow));
+        }
+
+      private:
+        ThreadPool & m_threadPool;
+        bool m_isToroidal;
+
+        // bit (row * 4) + column of the index is that cell of the 4x4 block, and
+        // bits 0-1 of the entry are the next center cells of row 1, bits 2-3 of row 2,
+        // shared by every TableEngine with the same rule
+        const std::vector<std::uint8_t> & m_table;
+
+        std::size_t m_width;
+        std::size_t m_height;
+        std::size_t m_pairCount;
+        std::size_t m_wordsPerRow;
+        Word_t m_lastWordMask;
+        std::vector<Word_t> m_words; // one padding row above, and one or two below
+        std::vector<Word_t> m_nextWords;
+    };
+
+} // namespace gameoflife
+
+#endif // TABLE_ENGINE_HPP_INCLUDED
@@ -0,0 +1,133 @@
+//
+// thread-pool.cpp
+//
+#include "thread-pool.hpp"
+
+#include <algorithm>
+
+namespace gameoflife
+{
+
+    ThreadPool::ThreadPool(const std::size_t t_threadCount)
+        : m_workers{}
+        , m_mutex{}
+        , m_workCondition{}
+        , m_doneCondition{}
+        , m_funcPtr{ nullptr }
+        , m_count{ 0 }
+        , m_bandCount{ 0 }
+        , m_remainingCount{ 0 }
+        , m_jobNumber{ 0 }
+        , m_isStopping{ false }
+    {
+        std::size_t threadCount{ t_threadCount };
+        if (0 == threadCount)
+        {
+            threadCount = std::max(1u, std::thread::hardware_concurrency());
+        }
+
+        // the calling thread always does band zero so it needs no worker
+        m_workers.reserve(threadCount - 1);
+        for (std::size_t index{ 1 }; index < threadCount; ++index)
+        {
+            m_workers.emplace_back(&ThreadPool::workerLoop, this, index);
+        }
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_isStopping = true;
+        }
+
+        m_workCondition.notify_all();
+
+        for (std::thread & worker : m_workers)
+        {
+            worker.join();
+        }
+    }
+
+    void ThreadPool::forEachBand(
+        const std::size_t t_count, const std::size_t t_minBandSize, const BandFunc_t & t_func)
+    {
+        if (0 == t_count)
+        {
+            return;
+        }
+
+        const std::size_t bandCount{ std::clamp(
+            (t_count / std::max(std::size_t{ 1 }, t_minBandSize)),
+            std::size_t{ 1 },
+            threadCount()) };
+
+        if (1 == bandCount)
+        {
+            t_func(0, t_count);
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_funcPtr        = &t_func;
+            m_count          = t_count;
+            m_bandCount      = bandCount;
+            m_remainingCount = (bandCount - 1);
+            ++m_jobNumber;
+        }
+
+        m_workCondition.notify_all();
+
+        t_func(0, bandBegin(1));
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_doneCondition.wait(lock, [&]() { return (0 == m_remainingCount); });
+        m_funcPtr = nullptr;
+    }
+
+    void ThreadPool::workerLoop(const std::size_t t_bandIndex)
+    {
+        std::size_t lastJobNumber{ 0 };
+
+        while (true)
+        {
+            std::size_t begin{ 0 };
+            std::size_t end{ 0 };
+            const BandFunc_t * funcPtr{ nullptr };
+
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_workCondition.wait(
+                    lock, [&]() { return (m_isStopping || (m_jobNumber != lastJobNumber)); });
+
+                if (m_isStopping)
+                {
+                    return;
+                }
+
+                lastJobNumber = m_jobNumber;
+
+                // small jobs use fewer bands than there are threads
+                if (t_bandIndex >= m_bandCount)
+                {
+                    continue;
+                }
+
+                begin   = bandBegin(t_bandIndex);
+                end     = bandBegin(t_bandIndex + 1);
+                funcPtr = m_funcPtr;
+            }
+
+            (*funcPtr)(begin, end);
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                --m_remainingCount;
+            }
+
+            m_doneCondition.notify_one();
+        }
+    }
+
+} // namespace gameoflife
@@ -0,0 +1,68 @@
+#ifndef THREAD_POOL_HPP_INCLUDED
+#define THREAD_POOL_HPP_INCLUDED
+//
+// thread-pool.hpp
+//
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace gameoflife
+{
+
+    // [begin, end)
+    using BandFunc_t = std::function<void(const std::size_t, const std::size_t)>;
+
+    // A fixed set of threads that are created once and then sleep between jobs.  The only kind
+    // of job is splitting a range into contiguous bands and running them all in parallel, with
+    // the calling thread doing the first band itself.
+    class ThreadPool
+    {
+      public:
+        // zero means std::thread::hardware_concurrency()
+        explicit ThreadPool(const std::size_t t_threadCount);
+        ~ThreadPool();
+
+        // prevent all copy and assignment
+        ThreadPool(const ThreadPool &) = delete;
+        ThreadPool(ThreadPool &&)      = delete;
+        //
+        ThreadPool & operator=(const ThreadPool &) = delete;
+        ThreadPool & operator=(ThreadPool &&)      = delete;
+
+        // includes the calling thread
+        std::size_t threadCount() const { return (m_workers.size() + 1); }
+
+        // Splits [0, t_count) into one band per thread and returns once they are all done.  Uses
+        // fewer bands if that would make any smaller than t_minBandSize, so small jobs stay on
+        // the calling thread where they are faster.  Not re-entrant.
+        void forEachBand(
+            const std::size_t t_count, const std::size_t t_minBandSize, const BandFunc_t & t_func);
+
+      private:
+        void workerLoop(const std::size_t t_bandIndex);
+
+        std::size_t bandBegin(const std::size_t t_bandIndex) const
+        {
+            return ((t_bandIndex * m_count) / m_bandCount);
+        }
+
+      private:
+        std::vector<std::thread> m_workers;
+        std::mutex m_mutex;
+        std::condition_variable m_workCondition;
+        std::condition_variable m_doneCondition;
+        const BandFunc_t * m_funcPtr;
+        std::size_t m_count;
+        std::size_t m_bandCount;
+        std::size_t m_remainingCount;
+        std::size_t m_jobNumber;
+        bool m_isStopping;
+    };
+
+} // namespace gameoflife
+
+#endif // THREAD_POOL_HPP_INCLUDED
@@ -0,0 +1,76 @@
+#ifndef TRIPLE_BUFFER_HPP_INCLUDED
+#define TRIPLE_BUFFER_HPP_INCLUDED
+//
+// triple-buffer.hpp
+//
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace gameoflife
+{
+
+    // Hands values from one writer thread to one reader thread without either ever waiting.
+    // The writer fills back() and publish() swaps it with the middle slot, and the reader's
+    // update() swaps the front slot with the middle only if something new was published.  So
+    // front() is always the newest complete value, and any the reader was too slow to see are
+    // simply overwritten.
+    template <typename T>
+    class TripleBuffer
+    {
+      public:
+        TripleBuffer()
+            : m_slots{}
+            , m_backIndex{ 0 }
+            , m_middle{ 1 }
+            , m_frontIndex{ 2 }
+        {}
+
+        // prevent all copy and assignment
+        TripleBuffer(const TripleBuffer &) = delete;
+        TripleBuffer(TripleBuffer &&)      = delete;
+        //
+        TripleBuffer & operator=(const TripleBuffer &) = delete;
+        TripleBuffer & operator=(TripleBuffer &&)      = delete;
+
+        // writer only, still holds some older value so overwrite all of it
+        T & back() { return m_slots[m_backIndex]; }
+
+        // writer only
+        void publish()
+        {
+            const std::uint8_t published{ static_cast<std::uint8_t>(m_backIndex | fresh_bit) };
+            m_backIndex = static_cast<std::uint8_t>(
+                m_middle.exchange(published, std::memory_order_acq_rel) & index_mask);
+        }
+
+        // reader only, returns true if front() changed
+        bool update()
+        {
+            if ((m_middle.load(std::memory_order_relaxed) & fresh_bit) == 0)
+            {
+                return false;
+            }
+
+            m_frontIndex = static_cast<std::uint8_t>(
+                m_middle.exchange(m_frontIndex, std::memory_order_acq_rel) & index_mask);
+            return true;
+        }
+
+        // reader only
+        const T & front() const { return m_slots[m_frontIndex]; }
+
+      private:
+        // the middle slot's index, plus this bit if the reader hasn't taken it yet
+        static constexpr std::uint8_t fresh_bit{ 0b100 };
+        static constexpr std::uint8_t index_mask{ 0b011 };
+
+        std::array<T, 3> m_slots;
+        std::uint8_t m_backIndex;
+        std::atomic<std::uint8_t> m_middle;
+        std::uint8_t m_frontIndex;
+    };
+
+} // namespace gameoflife
+
+#endif // TRIPLE_BUFFER_HPP_INCLUDED
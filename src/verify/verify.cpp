@@ -0,0 +1,577 @@
+//
+// verify.cpp
+//
+// A separate executable that proves every engine agrees with a naive oracle.  Random soups
+// under each of the common rules, and every preset under Conway's rule, are stepped one
+// generation at a time by the oracle and by every engine and SIMD level, the scalar reference
+// included, comparing a hash of each board every generation.  Then fresh boards are stepped
+// by single processSteps() calls of several sizes, so HashLife's jumps get checked too.  The
+// first generation and cell where an engine diverges is printed, and the exit code is
+// EXIT_FAILURE if any engine did.
+//
+// The oracle only uses Grid::getAliveCountAroundGridPosition() and Rule::isAliveNext(), one
+// cell at a time, so it shares none of the kernels or the masks built from the rule.
+//
+#include "cell-buffer.hpp"
+#include "config.hpp"
+#include "grid.hpp"
+#include "patterns.hpp"
+#include "rule.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace gameoflife
+{
+
+    namespace
+    {
+        // powers of two and odd counts between them, so HashLife splits them every way
+        constexpr std::array<std::size_t, 7> batch_step_counts{ 1, 2, 7, 16, 33, 64, 127 };
+
+        struct Options
+        {
+            // not multiples of anything, so the engines' partial words and tiles get checked
+            sf::Vector2u cell_counts{ 211u, 157u };
+            std::size_t generation_count{ 500 };
+            unsigned random_seed{ 12345 };
+            std::size_t thread_count{ 0 };
+            std::vector<EngineType> engines; // the reference means each of its SIMD kernels
+        };
+
+        struct Case
+        {
+            std::string start_name;
+            float density{ 0.0f };                  // of a random soup, if there is no pattern
+            const Pattern * pattern_ptr{ nullptr }; // centered on the board
+            std::string rule;
+            bool is_toroidal{ false };
+        };
+
+        // one of the engines, or the reference limited to one SIMD level
+        struct Variant
+        {
+            std::string name;
+            EngineType engine{ EngineType::Reference };
+            SimdLevel max_simd_level{ SimdLevel::Avx2 };
+        };
+
+        struct Contender
+        {
+            const Variant * variant_ptr;
+            std::unique_ptr<Grid> grid_ptr;
+        };
+
+        bool isUnbounded(const EngineType t_engine)
+        {
+            return ((t_engine == EngineType::HashLife) || (t_engine == EngineType::Sparse));
+        }
+
+        Options parseOptions(const int t_argc, const char * const t_argv[])
+        {
+            Options options;
+            options.engines = { EngineType::Reference, EngineType::BitPacked, EngineType::Tiled,
+                                EngineType::Table,     EngineType::Sparse,    EngineType::HashLife };
+
+            bool isEngineListed{ false };
+            for (int index{ 1 }; index < t_argc; ++index)
+            {
+                const std::string_view argument{ t_argv[index] };
+                const std::size_t equals{ argument.find('=') };
+                const std::string_view name{ argument.substr(0, equals) };
+                const std::string value{ (equals == std::string_view::npos)
+                                             ? std::string{}
+                                             : std::string{ argument.substr(equals + 1) } };
+
+                if (name == "--width")
+                {
+                    options.cell_counts.x = static_cast<unsigned>(std::stoul(value));
+                }
+                else if (name == "--height")
+                {
+                    options.cell_counts.y = static_cast<unsigned>(std::stoul(value));
+                }
+                else if (name == "--generations")
+                {
+                    options.generation_count = std::stoul(value);
+                }
+                else if (name == "--seed")
+                {
+                    options.random_seed = static_cast<unsigned>(std::stoul(value));
+                }
+                else if (name == "--threads")
+                {
+                    options.thread_count = std::stoul(value);
+                }
+                else if (name == "--engine")
+                {
+                    if (!isEngineListed)
+                    {
+                        options.engines.clear();
+                        isEngineListed = true;
+                    }
+
+                    options.engines.push_back(parseEngineType(value));
+                }
+                else
+                {
+                    throw std::runtime_error(
+                        "Unknown argument \"" + std::string{ argument } +
+                        "\".  Try --width=N, --height=N, --generations=N, --seed=N, --threads=N "
+                        "and --engine=NAME, which can be repeated.");
+                }
+            }
+
+            if ((options.cell_counts.x == 0) || (options.cell_counts.y == 0))
+            {
+                throw std::runtime_error("The board must be at least one cell wide and high.");
+            }
+
+            return options;
+        }
+
+        std::vector<Variant> makeVariants(const Options & t_options)
+        {
+            std::vector<Variant> variants;
+
+            for (const EngineType engine : t_options.engines)
+            {
+                if (engine != EngineType::Reference)
+                {
+                    variants.push_back({ std::string{ toString(engine) }, engine, SimdLevel::Avx2 });
+                    continue;
+                }
+
+                // the levels this CPU can't run would only repeat a lower level's result
+                for (const SimdLevel level :
+                     { SimdLevel::Scalar, SimdLevel::Sse2, SimdLevel::Avx2 })
+                {
+                    if (level <= detectSimdLevel())
+                    {
+                        variants.push_back(
+                            { (std::string{ toString(engine) } + '-' +
+                               std::string{ toString(level) }),
+                              engine,
+                              level });
+                    }
+                }
+            }
+
+            return variants;
+        }
+
+        std::vector<Case> makeCases()
+        {
+            std::vector<Case> cases;
+
+            for (const bool isToroidal : { false, true })
+            {
+                // the presets are all Conway patterns
+                for (const Pattern & pattern : presetPatterns())
+                {
+                    cases.push_back({ pattern.name, 0.0f, &pattern, "B3/S23", isToroidal });
+                }
+
+                // each rule with a kernel built just for it, and one that gets the generic kernel
+                for (const std::string_view rule :
+                     { "B3/S23", "B36/S23", "B2/S", "B3678/S34678", "B35/S236" })
+                {
+                    for (const float density : { 0.1f, 0.25f, 0.5f })
+                    {
+                        cases.push_back(
+                            { ("random-" + std::to_string(static_cast<int>(density * 100.0f)) +
+                               "%"),
+                              density,
+                              nullptr,
+                              std::string{ rule },
+                              isToroidal });
+                    }
+                }
+            }
+
+            return cases;
+        }
+
+        std::string describe(const Case & t_case, const Options & t_options)
+        {
+            return (
+                t_case.start_name + " on a " + std::to_string(t_options.cell_counts.x) + 'x' +
+                std::to_string(t_options.cell_counts.y) +
+                (t_case.is_toroidal ? " torus" : " board") + " with rule " + t_case.rule);
+        }
+
+        std::unique_ptr<Grid> makeGrid(
+            const Options & t_options,
+            const Case & t_case,
+            const EngineType t_engine,
+            const SimdLevel t_maxSimdLevel)
+        {
+            Config config;
+            config.cell_counts    = t_options.cell_counts;
+            config.rule           = t_case.rule;
+            config.is_toroidal    = t_case.is_toroidal;
+            config.engine         = t_engine;
+            config.thread_count   = t_options.thread_count;
+            config.max_simd_level = t_maxSimdLevel;
+
+            auto gridPtr{ std::make_unique<Grid>() };
+            gridPtr->reset(config);
+
+            const sf::Vector2i centerPosition{ t_options.cell_counts / 2u };
+            if (t_case.pattern_ptr == nullptr)
+            {
+                placePattern(
+                    *gridPtr,
+                    makeRandomPattern(
+                        t_options.cell_counts, t_case.density, t_options.random_seed),
+                    centerPosition);
+            }
+            else
+            {
+                placePattern(*gridPtr, *t_case.pattern_ptr, centerPosition);
+            }
+
+            return gridPtr;
+        }
+
+        // only called once the hashes differ, so it's fine that it's slow
+        std::optional<GridPos_t> findFirstDifference(
+            const Grid & t_expected, const Grid & t_actual, const sf::Vector2u & t_cellCounts)
+        {
+            for (int y{ 0 }; y < static_cast<int>(t_cellCounts.y); ++y)
+            {
+                for (int x{ 0 }; x < static_cast<int>(t_cellCounts.x); ++x)
+                {
+                    if (t_expected.getCellValue({ x, y }) != t_actual.getCellValue({ x, y }))
+                    {
+                        return GridPos_t{ x, y };
+                    }
+                }
+            }
+
+            return std::nullopt;
+        }
+
+        // once anything touches the edge, the unbounded engines rightly stop matching
+        bool isEdgeAlive(const Grid & t_grid, const sf::Vector2u & t_cellCounts)
+        {
+            const int right{ static_cast<int>(t_cellCounts.x) - 1 };
+            const int bottom{ static_cast<int>(t_cellCounts.y) - 1 };
+
+            for (int x{ 0 }; x <= right; ++x)
+            {
+                if ((t_grid.getCellValue({ x, 0 }) != 0) ||
+                    (t_grid.getCellValue({ x, bottom }) != 0))
+                {
+                    return true;
+                }
+            }
+
+            for (int y{ 0 }; y <= bottom; ++y)
+            {
+                if ((t_grid.getCellValue({ 0, y }) != 0) ||
+                    (t_grid.getCellValue({ right, y }) != 0))
+                {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        // the oracle, which is slow but too simple to share a mistake with any engine
+        void stepNaively(Grid & t_grid, const Rule & t_rule, CellBuffer & t_nextCells)
+        {
+            const CellBuffer & cells{ t_grid.cells() };
+            t_nextCells.resize(cells.width(), cells.height());
+
+            for (std::size_t y{ 0 }; y < cells.height(); ++y)
+            {
+                for (std::size_t x{ 0 }; x < cells.width(); ++x)
+                {
+                    const GridPos_t position{ static_cast<int>(x), static_cast<int>(y) };
+                    const bool isAlive{ t_grid.getCellValue(position) != 0 };
+
+                    t_nextCells.row(y)[x] =
+                        (t_rule.isAliveNext(
+                             isAlive, t_grid.getAliveCountAroundGridPosition(position))
+                             ? 1
+                             : 0);
+                }
+            }
+
+            t_grid.loadCells(t_nextCells);
+        }
+
+        std::vector<Contender> makeContenders(
+            const Options & t_options, const Case & t_case, const std::vector<Variant> & t_variants)
+        {
+            std::vector<Contender> contenders;
+            for (const Variant & variant : t_variants)
+            {
+                if (t_case.is_toroidal && isUnbounded(variant.engine))
+                {
+                    continue;
+                }
+
+                contenders.push_back(
+                    { &variant,
+                      makeGrid(t_options, t_case, variant.engine, variant.max_simd_level) });
+            }
+
+            return contenders;
+        }
+
+        void removeUnbounded(std::vector<Contender> & t_contenders)
+        {
+            const auto newEnd{ std::remove_if(
+                std::begin(t_contenders),
+                std::end(t_contenders),
+                [](const Contender & t_contender) {
+                    return isUnbounded(t_contender.variant_ptr->engine);
+                }) };
+
+            t_contenders.erase(newEnd, std::end(t_contenders));
+        }
+
+        // prints and removes every contender that doesn't match t_expected, returns false if any
+        bool removeMismatches(
+            const Grid & t_expected,
+            std::vector<Contender> & t_contenders,
+            const Options & t_options,
+            const std::string & t_description,
+            const std::string & t_when)
+        {
+            bool isEveryMatch{ true };
+            const std::uint64_t expectedHash{ t_expected.hashCells() };
+
+            for (auto iter{ std::begin(t_contenders) }; iter != std::end(t_contenders);)
+            {
+                if (iter->grid_ptr->hashCells() == expectedHash)
+                {
+                    ++iter;
+                    continue;
+                }
+
+                std::cout << "FAIL " << iter->variant_ptr->name << ", " << t_description
+                          << ": differs first " << t_when;
+
+                // a differing hash means a differing cell, so not finding one means the hash
+                // itself is broken
+                const std::optional<GridPos_t> positionOpt{
+                    findFirstDifference(t_expected, *iter->grid_ptr, t_options.cell_counts)
+                };
+
+                if (positionOpt)
+                {
+                    const GridPos_t & position{ positionOpt.value() };
+                    std::cout << ", cell (" << position.x << ',' << position.y << ") should be "
+                              << static_cast<int>(t_expected.getCellValue(position))
+                              << " but is "
+                              << static_cast<int>(iter->grid_ptr->getCellValue(position));
+                }
+                else
+                {
+                    std::cout << ", but only by hash since no cell differs";
+                }
+
+                std::cout << std::endl;
+
+                isEveryMatch = false;
+                iter         = t_contenders.erase(iter);
+            }
+
+            return isEveryMatch;
+        }
+
+        // every generation, one step at a time, up to t_options.generation_count
+        bool verifySingleSteps(
+            const Options & t_options,
+            const Case & t_case,
+            const std::vector<Variant> & t_variants,
+            const std::string & t_description)
+        {
+            const Rule rule{ parseRule(t_case.rule) };
+            CellBuffer nextCells;
+            const std::unique_ptr<Grid> oraclePtr{
+                makeGrid(t_options, t_case, EngineType::Reference, SimdLevel::Scalar)
+            };
+
+            std::vector<Contender> contenders{ makeContenders(t_options, t_case, t_variants) };
+
+            bool isEveryMatch{ true };
+            std::size_t generation{ 0 };
+            while (!contenders.empty())
+            {
+                // generation zero only loads and stores each engine, which is worth checking too
+                const std::size_t stepCount{ (generation == 0) ? 0u : 1u };
+                if (stepCount > 0)
+                {
+                    stepNaively(*oraclePtr, rule, nextCells);
+                }
+
+                for (Contender & contender : contenders)
+                {
+                    contender.grid_ptr->processSteps(stepCount);
+                }
+
+                if (!removeMismatches(
+                        *oraclePtr,
+                        contenders,
+                        t_options,
+                        t_description,
+                        ("at generation " + std::to_string(generation))))
+                {
+                    isEveryMatch = false;
+                }
+
+                if (generation == t_options.generation_count)
+                {
+                    break;
+                }
+
+                if (!t_case.is_toroidal && isEdgeAlive(*oraclePtr, t_options.cell_counts))
+                {
+                    removeUnbounded(contenders);
+                }
+
+                ++generation;
+            }
+
+            return isEveryMatch;
+        }
+
+        // each of batch_step_counts in one processSteps() call, one after the other from fresh
+        // boards, for as many as fit in t_options.generation_count
+        bool verifyBatchedSteps(
+            const Options & t_options,
+            const Case & t_case,
+            const std::vector<Variant> & t_variants,
+            const std::string & t_description)
+        {
+            const Rule rule{ parseRule(t_case.rule) };
+            CellBuffer nextCells;
+            const std::unique_ptr<Grid> oraclePtr{
+                makeGrid(t_options, t_case, EngineType::Reference, SimdLevel::Scalar)
+            };
+
+            std::vector<Contender> contenders{ makeContenders(t_options, t_case, t_variants) };
+
+            bool isEveryMatch{ true };
+            std::size_t generation{ 0 };
+            for (const std::size_t stepCount : batch_step_counts)
+            {
+                if (contenders.empty() || ((generation + stepCount) > t_options.generation_count))
+                {
+                    break;
+                }
+
+                // reaching the edge at any point in the batch spoils the unbounded engines' result
+                bool isEdgeReached{ false };
+                for (std::size_t count{ 0 }; count < stepCount; ++count)
+                {
+                    if (!t_case.is_toroidal && isEdgeAlive(*oraclePtr, t_options.cell_counts))
+                    {
+                        isEdgeReached = true;
+                    }
+
+                    stepNaively(*oraclePtr, rule, nextCells);
+                }
+
+                if (isEdgeReached)
+                {
+                    removeUnbounded(contenders);
+                }
+
+                for (Contender & contender : contenders)
+                {
+                    contender.grid_ptr->processSteps(stepCount);
+                }
+
+                if (!removeMismatches(
+                        *oraclePtr,
+                        contenders,
+                        t_options,
+                        t_description,
+                        ("after processSteps(" + std::to_string(stepCount) +
+                         ") from generation " + std::to_string(generation))))
+                {
+                    isEveryMatch = false;
+                }
+
+                generation += stepCount;
+            }
+
+            return isEveryMatch;
+        }
+
+        // returns false if any engine diverged from the oracle
+        bool verify(
+            const Options & t_options, const Case & t_case, const std::vector<Variant> & t_variants)
+        {
+            const std::string description{ describe(t_case, t_options) };
+
+            const bool isSingleMatch{ verifySingleSteps(
+                t_options, t_case, t_variants, description) };
+
+            const bool isBatchedMatch{ verifyBatchedSteps(
+                t_options, t_case, t_variants, description) };
+
+            if (isSingleMatch && isBatchedMatch)
+            {
+                std::cout << "ok   " << description << std::endl;
+            }
+
+            return (isSingleMatch && isBatchedMatch);
+        }
+    } // namespace
+
+} // namespace gameoflife
+
+int main(int argc, char * argv[])
+{
+    try
+    {
+        using namespace gameoflife;
+
+        const Options options{ parseOptions(argc, argv) };
+        const std::vector<Variant> variants{ makeVariants(options) };
+        const std::vector<Case> cases{ makeCases() };
+
+        std::cout << "Comparing";
+        for (const Variant & variant : variants)
+        {
+            std::cout << ' ' << variant.name;
+        }
+
+        std::cout << " against the naive oracle for " << options.generation_count
+                  << " generations..." << std::endl;
+
+        std::size_t failCount{ 0 };
+        for (const Case & testCase : cases)
+        {
+            if (!verify(options, testCase, variants))
+            {
+                ++failCount;
+            }
+        }
+
+        std::cout << (cases.size() - failCount) << " of " << cases.size() << " cases matched."
+                  << std::endl;
+
+        return ((failCount == 0) ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
+    catch (const std::exception & ex)
+    {
+        std::cerr << "Exception Error: " << ex.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+}